@@ -0,0 +1,468 @@
+#pragma once
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Doubly linked list whose nodes live in one array obtained from the allocator and link to
+// each other by 32-bit indices, so an int element costs 12 bytes instead of list's 24.
+// Slot 0 of the array is the sentinel; erased slots are kept on a free list. When the array
+// is full it is reallocated at twice the size, with a single memcpy for trivially copyable T.
+// Allocators with try_expand() first get the chance to grow the array where it lies: on a
+// StackAllocator that works while the array is the newest allocation, otherwise each old
+// array past the free lists' size classes stays behind in the arena until it is rewound.
+//
+// Iterators hold the container and a slot index, so like list's they survive insertion and
+// erasure of other elements, and even reallocation of the array. They are bound to the
+// container object though, which makes them invalid after swap() or a move.
+template <typename T, typename Alloc = std::allocator<T>>
+class compact_list {
+  static constexpr uint32_t kSentinel = 0;
+  static constexpr uint32_t kMinCapacity = 16;
+
+  struct Node {
+    uint32_t next;
+    uint32_t prev;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T* value() { return reinterpret_cast<T*>(storage); }
+  };
+
+  template <bool isConst>
+  class base_iterator {
+  public:
+    using reference_type = std::conditional_t<isConst, const T&, T&>;
+    using pointer_type = std::conditional_t<isConst, const T*, T*>;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+  private:
+
+    compact_list* owner;
+    uint32_t index;
+    base_iterator(const compact_list* owner, uint32_t index): owner(const_cast<compact_list*>(owner)), index(index) {}
+
+    friend class compact_list<T, Alloc>;
+  public:
+    base_iterator() = default;
+    base_iterator(const base_iterator&) = default;
+    base_iterator& operator=(const base_iterator&) = default;
+    bool operator==(const base_iterator&) const = default;
+
+    reference_type operator*() const { return *owner->nodes_[index].value(); }
+    pointer_type operator->() const { return owner->nodes_[index].value(); }
+
+    base_iterator& operator++() {
+      index = owner->nodes_[index].next;
+      return *this;
+    }
+
+    base_iterator operator++(int) {
+      base_iterator copy = *this;
+      index = owner->nodes_[index].next;
+      return copy;
+    }
+
+    base_iterator& operator--() {
+      index = owner->nodes_[index].prev;
+      return *this;
+    }
+
+    base_iterator operator--(int) {
+      base_iterator copy = *this;
+      index = owner->nodes_[index].prev;
+      return copy;
+    }
+
+    operator base_iterator<true>() const {
+      return {owner, index};
+    }
+  };
+
+  using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static constexpr bool kExpandInPlace =
+      requires(node_allocator& alloc, Node* nodes, size_t n) { { alloc.try_expand(nodes, n, n) } -> std::same_as<bool>; };
+
+  Node* nodes_ = nullptr;
+  uint32_t capacity_ = 0; // slots in nodes_, the sentinel included
+  uint32_t used_ = 0;     // slots ever handed out, the rest were never touched
+  uint32_t free_ = kSentinel; // head of the free slots, linked through next
+  size_t sz_ = 0;
+  node_allocator alloc_;
+
+  // Moves everything into an array of `capacity` slots
+  void reallocate(uint32_t capacity);
+  // Returns a free slot, growing the array if there is none; `value` is constructed there
+  template <typename... Args>
+  uint32_t create_node(Args&&... args);
+  void destroy_node(uint32_t index);
+
+  void link_before(uint32_t pos, uint32_t index);
+  void unlink(uint32_t index);
+
+  // Destroys the elements and gives the array back
+  void release();
+  void steal(compact_list& other);
+
+public:
+
+  using value_type = T;
+  using allocator_type = Alloc;
+
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() { return { this, nodes_ != nullptr ? nodes_[kSentinel].next : kSentinel }; }
+  iterator end() { return { this, kSentinel }; }
+
+  const_iterator begin() const { return { this, nodes_ != nullptr ? nodes_[kSentinel].next : kSentinel }; }
+  const_iterator end() const { return { this, kSentinel }; }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  compact_list(): alloc_(node_allocator()) {}
+  explicit compact_list(const Alloc& allocator): alloc_(allocator) {}
+  compact_list(size_t count, const T& value, const Alloc& allocator = Alloc());
+  compact_list(std::initializer_list<T> values, const Alloc& allocator = Alloc());
+  compact_list(const compact_list& other);
+  compact_list(compact_list&& other) noexcept;
+
+  ~compact_list();
+
+  compact_list& operator=(const compact_list& other);
+  compact_list& operator=(compact_list&& other)
+      noexcept(node_traits::propagate_on_container_move_assignment::value
+               || node_traits::is_always_equal::value);
+
+  void swap(compact_list& other);
+  void clear() noexcept;
+
+  // Slots for `count` elements without reallocating; the sentinel takes one more
+  void reserve(size_t count);
+  size_t capacity() const { return capacity_ == 0 ? 0 : capacity_ - 1; }
+  static constexpr size_t max_size() { return std::numeric_limits<uint32_t>::max() - 1; }
+
+  void push_back(const T& elem) { emplace(end(), elem); }
+  void push_back(T&& elem) { emplace(end(), std::move(elem)); }
+  void push_front(const T& elem) { emplace(begin(), elem); }
+  void push_front(T&& elem) { emplace(begin(), std::move(elem)); }
+  void pop_back() { erase(std::prev(end())); }
+  void pop_front() { erase(begin()); }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) { return *emplace(end(), std::forward<Args>(args)...); }
+  template <typename... Args>
+  T& emplace_front(Args&&... args) { return *emplace(begin(), std::forward<Args>(args)...); }
+
+  iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+  iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator erase(const_iterator pos);
+
+  size_t size() const { return sz_; }
+  bool empty() const { return sz_ == 0; }
+  allocator_type get_allocator() const { return alloc_; }
+};
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::reallocate(uint32_t capacity) {
+  if constexpr (kExpandInPlace) {
+    if (nodes_ != nullptr && capacity > capacity_ && alloc_.try_expand(nodes_, capacity_, capacity)) {
+      capacity_ = capacity;
+      return;
+    }
+  }
+  Node* nodes = node_traits::allocate(alloc_, capacity);
+  if (nodes_ == nullptr) {
+    nodes[kSentinel].next = kSentinel;
+    nodes[kSentinel].prev = kSentinel;
+    used_ = 1;
+  } else if constexpr (std::is_trivially_copyable_v<T>) {
+    // Links are indices, so the bytes are valid anywhere
+    std::memcpy(static_cast<void*>(nodes), nodes_, used_ * sizeof(Node));
+    node_traits::deallocate(alloc_, nodes_, capacity_);
+  } else {
+    for (uint32_t i = 0; i < used_; ++i) {
+      nodes[i].next = nodes_[i].next;
+      nodes[i].prev = nodes_[i].prev;
+    }
+    // Elements whose move may throw are copied, so a failure leaves the old array intact
+    uint32_t i = nodes_[kSentinel].next;
+    try {
+      for (; i != kSentinel; i = nodes_[i].next) {
+        std::construct_at(nodes[i].value(), std::move_if_noexcept(*nodes_[i].value()));
+      }
+    } catch(...) {
+      for (uint32_t j = nodes_[kSentinel].next; j != i; j = nodes_[j].next) {
+        std::destroy_at(nodes[j].value());
+      }
+      node_traits::deallocate(alloc_, nodes, capacity);
+      throw;
+    }
+    for (i = nodes_[kSentinel].next; i != kSentinel; i = nodes_[i].next) {
+      std::destroy_at(nodes_[i].value());
+    }
+    node_traits::deallocate(alloc_, nodes_, capacity_);
+  }
+  nodes_ = nodes;
+  capacity_ = capacity;
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+uint32_t compact_list<T, Alloc>::create_node(Args&&... args) {
+  uint32_t index;
+  if (free_ != kSentinel) {
+    index = free_;
+    free_ = nodes_[index].next;
+  } else if (used_ < capacity_) {
+    index = used_++;
+  } else {
+    if (capacity_ == std::numeric_limits<uint32_t>::max()) {
+      throw std::length_error("compact_list is out of 32-bit indices");
+    }
+    // `args` may refer to an element of the old array, so the value is built first
+    T value(std::forward<Args>(args)...);
+    uint64_t grown = std::max<uint64_t>(kMinCapacity, uint64_t{capacity_} * 2);
+    reallocate(static_cast<uint32_t>(std::min<uint64_t>(grown, max_size() + 1)));
+    index = used_++;
+    std::construct_at(nodes_[index].value(), std::move(value));
+    return index;
+  }
+
+  try {
+    std::construct_at(nodes_[index].value(), std::forward<Args>(args)...);
+  } catch(...) {
+    nodes_[index].next = free_;
+    free_ = index;
+    throw;
+  }
+  return index;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::destroy_node(uint32_t index) {
+  std::destroy_at(nodes_[index].value());
+  nodes_[index].next = free_;
+  free_ = index;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::link_before(uint32_t pos, uint32_t index) {
+  uint32_t prev = nodes_[pos].prev;
+  nodes_[index].next = pos;
+  nodes_[index].prev = prev;
+  nodes_[prev].next = index;
+  nodes_[pos].prev = index;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::unlink(uint32_t index) {
+  nodes_[nodes_[index].prev].next = nodes_[index].next;
+  nodes_[nodes_[index].next].prev = nodes_[index].prev;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::release() {
+  if (nodes_ == nullptr) {
+    return;
+  }
+  clear();
+  node_traits::deallocate(alloc_, nodes_, capacity_);
+  nodes_ = nullptr;
+  capacity_ = 0;
+  used_ = 0;
+  free_ = kSentinel;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::steal(compact_list& other) {
+  nodes_ = std::exchange(other.nodes_, nullptr);
+  capacity_ = std::exchange(other.capacity_, 0);
+  used_ = std::exchange(other.used_, 0);
+  free_ = std::exchange(other.free_, kSentinel);
+  sz_ = std::exchange(other.sz_, 0);
+}
+
+template <typename T, typename Alloc>
+compact_list<T, Alloc>::compact_list(size_t count, const T& value, const Alloc& allocator)
+    : alloc_(allocator) {
+  try {
+    reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      push_back(value);
+    }
+  } catch(...) {
+    release();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc>
+compact_list<T, Alloc>::compact_list(std::initializer_list<T> values, const Alloc& allocator)
+    : alloc_(allocator) {
+  try {
+    reserve(values.size());
+    for (const T& value : values) {
+      push_back(value);
+    }
+  } catch(...) {
+    release();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc>
+compact_list<T, Alloc>::compact_list(const compact_list& other)
+    : alloc_(node_traits::select_on_container_copy_construction(other.alloc_)) {
+  try {
+    reserve(other.sz_);
+    for (const T& value : other) {
+      push_back(value);
+    }
+  } catch(...) {
+    release();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc>
+compact_list<T, Alloc>::compact_list(compact_list&& other) noexcept
+    : alloc_(other.alloc_) {
+  steal(other);
+}
+
+template <typename T, typename Alloc>
+compact_list<T, Alloc>::~compact_list() {
+  release();
+}
+
+template <typename T, typename Alloc>
+auto compact_list<T, Alloc>::operator=(const compact_list& other) -> compact_list& {
+  if (this == &other) {
+    return *this;
+  }
+
+  if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+    if (!(alloc_ == other.alloc_)) {
+      release();
+    }
+    alloc_ = other.alloc_;
+  }
+  clear();
+  reserve(other.sz_);
+  for (const T& value : other) {
+    push_back(value);
+  }
+  return *this;
+}
+
+template <typename T, typename Alloc>
+auto compact_list<T, Alloc>::operator=(compact_list&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value
+             || node_traits::is_always_equal::value) -> compact_list& {
+  if (this == &other) {
+    return *this;
+  }
+
+  if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+    if (!(alloc_ == other.alloc_)) {
+      // The array belongs to the other allocator, move the elements instead
+      clear();
+      reserve(other.sz_);
+      for (T& value : other) {
+        push_back(std::move(value));
+      }
+      other.clear();
+      return *this;
+    }
+  }
+  release();
+  if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+    alloc_ = other.alloc_;
+  }
+  steal(other);
+  return *this;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::swap(compact_list& other) {
+  using std::swap;
+  swap(nodes_, other.nodes_);
+  swap(capacity_, other.capacity_);
+  swap(used_, other.used_);
+  swap(free_, other.free_);
+  swap(sz_, other.sz_);
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    swap(alloc_, other.alloc_);
+  }
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::clear() noexcept {
+  if (nodes_ == nullptr) {
+    return;
+  }
+  if constexpr (!std::is_trivially_destructible_v<T>) {
+    for (uint32_t i = nodes_[kSentinel].next; i != kSentinel; i = nodes_[i].next) {
+      std::destroy_at(nodes_[i].value());
+    }
+  }
+  // Every slot is untouched again
+  nodes_[kSentinel].next = kSentinel;
+  nodes_[kSentinel].prev = kSentinel;
+  used_ = 1;
+  free_ = kSentinel;
+  sz_ = 0;
+}
+
+template <typename T, typename Alloc>
+void compact_list<T, Alloc>::reserve(size_t count) {
+  if (count > max_size()) {
+    throw std::length_error("compact_list is out of 32-bit indices");
+  }
+  if (count + 1 > capacity_) {
+    reallocate(static_cast<uint32_t>(count + 1));
+  }
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+auto compact_list<T, Alloc>::emplace(const_iterator pos, Args&&... args) -> iterator {
+  uint32_t index = create_node(std::forward<Args>(args)...);
+  link_before(pos.index, index);
+  ++sz_;
+  return { this, index };
+}
+
+template <typename T, typename Alloc>
+auto compact_list<T, Alloc>::erase(const_iterator pos) -> iterator {
+  uint32_t next = nodes_[pos.index].next;
+  unlink(pos.index);
+  destroy_node(pos.index);
+  --sz_;
+  return { this, next };
+}
@@ -0,0 +1,371 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "list.h"
+
+// list with an order-statistic index for positional access. Every element has a rank node
+// in an implicit treap: a randomized balanced tree ordered by list position, whose nodes
+// count their subtrees and link to their parents. nth() and index_of() take O(log n)
+// instead of walking the list, and insertion and erasure keep the tree current in
+// O(log n) as well. Plain list pays for none of it.
+//
+// Iterators and their validity are those of list.
+template <typename T, typename Alloc = std::allocator<T>>
+class indexed_list {
+  struct RankNode;
+
+  struct Entry {
+    T value;
+    RankNode* rank;
+
+    template <typename... Args>
+    Entry(std::in_place_t, Args&&... args): value(std::forward<Args>(args)...), rank(nullptr) {}
+  };
+
+  using entry_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+  using entry_list = list<Entry, entry_allocator>;
+
+  struct RankNode {
+    RankNode* left;
+    RankNode* right;
+    RankNode* parent;
+    size_t size;
+    uint32_t priority;
+    typename entry_list::iterator entry;
+  };
+
+  using rank_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<RankNode>;
+  using rank_traits = std::allocator_traits<rank_allocator>;
+
+  template <bool isConst>
+  class base_iterator {
+  public:
+    using reference_type = std::conditional_t<isConst, const T&, T&>;
+    using pointer_type = std::conditional_t<isConst, const T*, T*>;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+  private:
+    using entry_iterator = std::conditional_t<isConst, typename entry_list::const_iterator,
+                                              typename entry_list::iterator>;
+
+    entry_iterator it;
+    base_iterator(entry_iterator it): it(it) {}
+
+    friend class indexed_list<T, Alloc>;
+  public:
+    base_iterator(): it() {}
+    base_iterator(const base_iterator&) = default;
+    base_iterator& operator=(const base_iterator&) = default;
+    bool operator==(const base_iterator&) const = default;
+
+    reference_type operator*() const { return it->value; }
+    pointer_type operator->() const { return &it->value; }
+
+    base_iterator& operator++() {
+      ++it;
+      return *this;
+    }
+
+    base_iterator operator++(int) {
+      base_iterator copy = *this;
+      ++it;
+      return copy;
+    }
+
+    base_iterator& operator--() {
+      --it;
+      return *this;
+    }
+
+    base_iterator operator--(int) {
+      base_iterator copy = *this;
+      --it;
+      return copy;
+    }
+
+    operator base_iterator<true>() const {
+      return {it};
+    }
+  };
+
+  entry_list entries_;
+  rank_allocator rank_alloc_;
+  RankNode* root_ = nullptr;
+  uint32_t seed_ = 0x9e3779b9; // xorshift state for treap priorities
+
+  static size_t size_of(const RankNode* node) { return node != nullptr ? node->size : 0; }
+  // Recounts `node` and points its children back at it
+  static void update(RankNode* node);
+  // Cuts off the first `count` positions of the subtree
+  static std::pair<RankNode*, RankNode*> split(RankNode* node, size_t count);
+  static RankNode* merge(RankNode* left, RankNode* right);
+  static size_t rank_of(const RankNode* node);
+
+  uint32_t next_priority();
+  void destroy_ranks();
+
+public:
+
+  using value_type = T;
+  using allocator_type = Alloc;
+
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  indexed_list(): indexed_list(Alloc()) {}
+  explicit indexed_list(const Alloc& allocator): entries_(entry_allocator(allocator)), rank_alloc_(allocator) {}
+  indexed_list(std::initializer_list<T> values, const Alloc& allocator = Alloc());
+  indexed_list(const indexed_list& other);
+  indexed_list(indexed_list&& other) noexcept;
+
+  ~indexed_list() { destroy_ranks(); }
+
+  indexed_list& operator=(const indexed_list& other);
+  indexed_list& operator=(indexed_list&& other) noexcept;
+
+  void swap(indexed_list& other) noexcept;
+
+  iterator begin() { return {entries_.begin()}; }
+  iterator end() { return {entries_.end()}; }
+  const_iterator begin() const { return {entries_.begin()}; }
+  const_iterator end() const { return {entries_.end()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  size_t size() const { return entries_.size(); }
+  bool empty() const { return entries_.size() == 0; }
+  allocator_type get_allocator() const { return Alloc(rank_alloc_); }
+
+  // Element at position `index` (end() for index == size()) and the position of `pos`
+  iterator nth(size_t index);
+  const_iterator nth(size_t index) const;
+  size_t index_of(const_iterator pos) const;
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+  iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+  iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+  void push_back(const T& value) { emplace(cend(), value); }
+  void push_back(T&& value) { emplace(cend(), std::move(value)); }
+  void push_front(const T& value) { emplace(cbegin(), value); }
+  void push_front(T&& value) { emplace(cbegin(), std::move(value)); }
+
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  void pop_back() { erase(std::prev(cend())); }
+  void pop_front() { erase(cbegin()); }
+  void clear() noexcept;
+};
+
+template <typename T, typename Alloc>
+void indexed_list<T, Alloc>::update(RankNode* node) {
+  node->size = 1 + size_of(node->left) + size_of(node->right);
+  if (node->left != nullptr) {
+    node->left->parent = node;
+  }
+  if (node->right != nullptr) {
+    node->right->parent = node;
+  }
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::split(RankNode* node, size_t count) -> std::pair<RankNode*, RankNode*> {
+  if (node == nullptr) {
+    return {nullptr, nullptr};
+  }
+  if (count <= size_of(node->left)) {
+    auto [left, right] = split(node->left, count);
+    node->left = right;
+    update(node);
+    if (left != nullptr) {
+      left->parent = nullptr;
+    }
+    return {left, node};
+  }
+  auto [left, right] = split(node->right, count - size_of(node->left) - 1);
+  node->right = left;
+  update(node);
+  if (right != nullptr) {
+    right->parent = nullptr;
+  }
+  return {node, right};
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::merge(RankNode* left, RankNode* right) -> RankNode* {
+  if (left == nullptr || right == nullptr) {
+    return left != nullptr ? left : right;
+  }
+  if (left->priority > right->priority) {
+    left->right = merge(left->right, right);
+    update(left);
+    return left;
+  }
+  right->left = merge(left, right->left);
+  update(right);
+  return right;
+}
+
+template <typename T, typename Alloc>
+size_t indexed_list<T, Alloc>::rank_of(const RankNode* node) {
+  size_t index = size_of(node->left);
+  for (; node->parent != nullptr; node = node->parent) {
+    if (node == node->parent->right) {
+      index += size_of(node->parent->left) + 1;
+    }
+  }
+  return index;
+}
+
+template <typename T, typename Alloc>
+uint32_t indexed_list<T, Alloc>::next_priority() {
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+  return seed_;
+}
+
+template <typename T, typename Alloc>
+void indexed_list<T, Alloc>::destroy_ranks() {
+  for (Entry& entry : entries_) {
+    rank_traits::deallocate(rank_alloc_, entry.rank, 1);
+  }
+  root_ = nullptr;
+}
+
+template <typename T, typename Alloc>
+indexed_list<T, Alloc>::indexed_list(std::initializer_list<T> values, const Alloc& allocator)
+    : indexed_list(allocator) {
+  for (const T& value : values) {
+    push_back(value);
+  }
+}
+
+template <typename T, typename Alloc>
+indexed_list<T, Alloc>::indexed_list(const indexed_list& other)
+    : indexed_list(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator())) {
+  for (const T& value : other) {
+    push_back(value);
+  }
+}
+
+template <typename T, typename Alloc>
+indexed_list<T, Alloc>::indexed_list(indexed_list&& other) noexcept
+    : entries_(std::move(other.entries_)), rank_alloc_(other.rank_alloc_),
+      root_(std::exchange(other.root_, nullptr)), seed_(other.seed_) {}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::operator=(const indexed_list& other) -> indexed_list& {
+  if (this != &other) {
+    indexed_list copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::operator=(indexed_list&& other) noexcept -> indexed_list& {
+  if (this != &other) {
+    indexed_list moved(std::move(other));
+    swap(moved);
+  }
+  return *this;
+}
+
+template <typename T, typename Alloc>
+void indexed_list<T, Alloc>::swap(indexed_list& other) noexcept {
+  using std::swap;
+  entries_.swap(other.entries_);
+  swap(rank_alloc_, other.rank_alloc_);
+  swap(root_, other.root_);
+  swap(seed_, other.seed_);
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::nth(size_t index) -> iterator {
+  if (index >= size()) {
+    return end();
+  }
+  RankNode* node = root_;
+  while (index != size_of(node->left)) {
+    if (index < size_of(node->left)) {
+      node = node->left;
+    } else {
+      index -= size_of(node->left) + 1;
+      node = node->right;
+    }
+  }
+  return {node->entry};
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::nth(size_t index) const -> const_iterator {
+  return const_cast<indexed_list*>(this)->nth(index);
+}
+
+template <typename T, typename Alloc>
+size_t indexed_list<T, Alloc>::index_of(const_iterator pos) const {
+  return pos == cend() ? size() : rank_of(pos.it->rank);
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+auto indexed_list<T, Alloc>::emplace(const_iterator pos, Args&&... args) -> iterator {
+  size_t index = index_of(pos);
+  RankNode* node = rank_traits::allocate(rank_alloc_, 1);
+  typename entry_list::iterator entry;
+  try {
+    entry = entries_.emplace(pos.it, std::in_place, std::forward<Args>(args)...);
+  } catch(...) {
+    rank_traits::deallocate(rank_alloc_, node, 1);
+    throw;
+  }
+
+  ::new (static_cast<void*>(node)) RankNode{nullptr, nullptr, nullptr, 1, next_priority(), entry};
+  entry->rank = node;
+  auto [left, right] = split(root_, index);
+  root_ = merge(merge(left, node), right);
+  root_->parent = nullptr;
+  return {entry};
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::erase(const_iterator pos) -> iterator {
+  RankNode* node = pos.it->rank;
+  auto [left, rest] = split(root_, rank_of(node));
+  auto [removed, right] = split(rest, 1);
+  root_ = merge(left, right);
+  if (root_ != nullptr) {
+    root_->parent = nullptr;
+  }
+  rank_traits::deallocate(rank_alloc_, removed, 1);
+  return {entries_.erase(pos.it)};
+}
+
+template <typename T, typename Alloc>
+auto indexed_list<T, Alloc>::erase(const_iterator first, const_iterator last) -> iterator {
+  while (first != last) {
+    first = erase(first);
+  }
+  return {entries_.erase(last.it, last.it)};
+}
+
+template <typename T, typename Alloc>
+void indexed_list<T, Alloc>::clear() noexcept {
+  destroy_ranks();
+  entries_.clear();
+}
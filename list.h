@@ -1,23 +1,50 @@
 #pragma once
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <ranges>
+#include <thread>
 #include <type_traits>
+#include <utility>
+#include <vector>
+
+// Selects the multi-threaded list::sort, like std::execution::par does for the standard
+// algorithms (<execution> itself is avoided, as libstdc++ makes it depend on TBB).
+struct parallel_sort_policy {
+  // Shorter lists are not worth splitting that far
+  static constexpr size_t kMinNodesPerThread = 1 << 12;
+
+  size_t threads = 0; // 0 means std::thread::hardware_concurrency()
+};
+
+inline constexpr parallel_sort_policy parallel_sort{};
 
 template <typename T, typename Alloc = std::allocator<T>>
 class list {
+  struct BaseNode;
+  // Links use the allocator's pointer type, so with a self-relative one such as OffsetPtr
+  // the list can live in memory that is copied or mapped at different addresses
+  using base_pointer = typename std::pointer_traits<typename std::allocator_traits<Alloc>::pointer>
+                           ::template rebind<BaseNode>;
+
   struct BaseNode {
-    BaseNode* next;
-    BaseNode* prev;
+    base_pointer next;
+    base_pointer prev;
 
     BaseNode() = default;
-    BaseNode(BaseNode* next, BaseNode* prev): next(next), prev(prev) {}
+    BaseNode(base_pointer next, base_pointer prev): next(next), prev(prev) {}
   };
 
   struct Node : BaseNode {
     T data;
 
     template <typename... Args>
-    Node(BaseNode* next, BaseNode* prev, Args&&... args): BaseNode(next, prev), data(std::forward<Args>(args)...) {}
+    Node(base_pointer next, base_pointer prev, Args&&... args): BaseNode(next, prev), data(std::forward<Args>(args)...) {}
   };
   
 
@@ -33,54 +60,179 @@ class list {
   
   private:
 
-    BaseNode* ptr;
-    base_iterator(BaseNode* ptr): ptr(ptr) {}
-    base_iterator(const BaseNode* ptr): ptr(const_cast<BaseNode*>(ptr)) {}
+    base_pointer ptr = nullptr;
+    bool reversed = false; // orientation of the list when the iterator was made
+    base_iterator(base_pointer ptr, bool reversed): ptr(ptr), reversed(reversed) {}
+    base_iterator(const BaseNode* ptr, bool reversed): ptr(const_cast<BaseNode*>(ptr)), reversed(reversed) {}
 
     friend class list<T, Alloc>;
   public:
     base_iterator() = default;
     base_iterator(const base_iterator&) = default;
     base_iterator& operator=(const base_iterator&) = default;
-    bool operator==(const base_iterator&) const = default; 
+    bool operator==(const base_iterator& other) const { return ptr == other.ptr; }
 
-    reference_type operator*() const { return static_cast<Node*>(ptr)->data; }
-    pointer_type operator->() const { return &(static_cast<Node*>(ptr)->data); }
+    reference_type operator*() const { return static_cast<Node&>(*ptr).data; }
+    pointer_type operator->() const { return &(static_cast<Node&>(*ptr).data); }
 
     base_iterator& operator++() {
-      ptr = ptr->next;
+      ptr = reversed ? ptr->prev : ptr->next;
       return *this;
     }
 
     base_iterator operator++(int) {
       base_iterator copy = *this;
-      ptr = ptr->next;
+      ++*this;
       return copy;
     }
 
     base_iterator& operator--() {
-      ptr = ptr->prev;
+      ptr = reversed ? ptr->next : ptr->prev;
       return *this;
     }
 
     base_iterator operator--(int) {
       base_iterator copy = *this;
-      ptr = ptr->prev;
+      --*this;
       return copy;
     }
 
     operator base_iterator<true>() const {
-      return {ptr};
+      return {ptr, reversed};
     }
   };
 
   using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>; 
+  using node_traits = std::allocator_traits<node_allocator>;
+  using node_pointer = typename node_traits::pointer;
+  using void_pointer = typename node_traits::void_pointer;
 
-  void swap(list& other);
-
+  // The list is circular: the first node's prev and the last node's next point to fakeNode_
   BaseNode fakeNode_; // fakeNode_.next -> start of the list, fakeNode_.prev -> end of the list
   node_allocator alloc_; // allocator for Node
   size_t sz_;
+  // Set by reverse(): the elements are then read from fakeNode_.prev towards fakeNode_.next
+  bool reversed_ = false;
+
+  // Memory of erased nodes kept for reuse, linked through its first word
+  struct SpareNode;
+  using spare_pointer = typename std::pointer_traits<void_pointer>::template rebind<SpareNode>;
+  struct SpareNode {
+    spare_pointer next;
+  };
+  spare_pointer spare_ = nullptr;
+  spare_pointer spare_last_ = nullptr; // end of the chain, meaningful while spare_ is set
+  size_t spare_count_ = 0;
+  // Allocators counting rewinds let the cache notice that a rewind took its nodes back.
+  // All spares are forgotten then, as the ones from before the marker are not told apart.
+  static constexpr bool kRewindAware =
+      requires(const node_allocator& alloc) { { alloc.rewind_count() } -> std::convertible_to<size_t>; };
+  size_t spare_generation_ = 0; // rewind_count() when the spares were cached
+  bool spares_stale() const;
+  void drop_stale_spares();
+
+  // create_node() takes a spare node when there is one, destroy_node() makes the node spare
+  template <typename... Args>
+  node_pointer create_node(Args&&... args);
+  void destroy_node(base_pointer node);
+
+  node_pointer allocate_node();
+  void push_spare(node_pointer node);
+  void release_spare_nodes();
+
+  // Destroying a node is a no-op unless T or the allocator has something to do
+  static constexpr bool kTrivialDestroy =
+      std::is_trivially_destructible_v<Node>
+      && !requires(node_allocator& alloc, Node* node) { alloc.destroy(node); };
+
+  // Arena allocators may take back a whole chain of spare nodes in one call
+  static constexpr bool kChainDeallocation =
+      requires(node_allocator& alloc, node_pointer node) { alloc.deallocate_chain(node, node, size_t{}); };
+
+  // Allocators declaring `splits_bulk_allocations` accept allocate(n) memory back
+  // one node at a time, so the nodes of a range can come from a single block
+  static constexpr bool kBulkNodeAllocation =
+      requires { requires node_allocator::splits_bulk_allocations::value; };
+
+  // Allocators reporting how many StackRegions are open let ~list() leave trivially
+  // destructible nodes to the region's rewind
+  static constexpr bool kRegionAware =
+      std::is_trivially_destructible_v<T>
+      && requires(const node_allocator& alloc) { { alloc.region_depth() } -> std::convertible_to<size_t>; };
+
+  static size_t region_depth_of(const node_allocator& alloc) {
+    if constexpr (kRegionAware) {
+      return alloc.region_depth();
+    } else {
+      return 0;
+    }
+  }
+
+  // Regions open when the list was created. Its nodes all come after the innermost one's
+  // marker only while that region is still the innermost, and nodes taken over from other
+  // lists lower the value to theirs.
+  size_t region_depth_ = region_depth_of(alloc_);
+  void take_region_depth(const list& other) { region_depth_ = std::min(region_depth_, other.region_depth_); }
+
+  // Makes sure there are at least `count` spare nodes
+  void reserve_spares(size_t count);
+
+  static void link_before(base_pointer pos, base_pointer node);
+  // Physical position to link before so that the node lands logically before `pos`
+  base_pointer link_position(base_pointer pos) const { return reversed_ ? pos->next : pos; }
+  static void unlink(base_pointer node);
+  // Moves the nodes [first, last) before pos, which must not be among them
+  static void transfer(base_pointer pos, base_pointer first, base_pointer last);
+
+  static T& value_of(base_pointer node) { return static_cast<Node&>(*node).data; }
+
+  // Sorting works on null-terminated chains whose first node's prev points to the last one.
+  // merge_chains() moves all of `from` into `into` keeping `into` first among equals;
+  // if the comparator throws, `into` still holds every node of both chains.
+  template <typename Compare>
+  static void merge_chains(base_pointer& into, base_pointer& from, Compare& cmp);
+  // Attaches a null-terminated chain of sz_ nodes to fakeNode_ and restores prev links
+  void adopt_chain(base_pointer first);
+  // Same for a chain produced by sort_chain(), whose prev links are already right
+  void adopt_sorted_chain(base_pointer first);
+  // Puts the null-terminated chain `piece` in front of `chain`
+  static void prepend_chain(base_pointer& chain, base_pointer piece);
+  // Sorts a null-terminated chain; if the comparator throws, `chain` still holds all nodes
+  template <typename Compare>
+  static void sort_chain(base_pointer& chain, Compare& cmp);
+
+  // Swaps next and prev of `sentinel` and every node of its cycle
+  static void swap_links(BaseNode& sentinel);
+  // Moves the nodes [first, last) of `from`, taken in its logical order, logically before `pos`
+  void transfer_from(const list& from, base_pointer pos, base_pointer first, base_pointer last);
+
+  // Links a reversed list in its logical order for the guard's lifetime, for operations
+  // that walk next pointers. Flipping back afterwards keeps iterators made after reverse()
+  // walking the right way.
+  class ForwardLinks {
+    list& lst_;
+    bool was_reversed_;
+
+  public:
+    explicit ForwardLinks(list& lst): lst_(lst), was_reversed_(lst.reversed_) {
+      if (was_reversed_) {
+        swap_links(lst_.fakeNode_);
+        lst_.reversed_ = false;
+      }
+    }
+    ForwardLinks(const ForwardLinks&) = delete;
+    ForwardLinks& operator=(const ForwardLinks&) = delete;
+    ~ForwardLinks() {
+      if (was_reversed_) {
+        swap_links(lst_.fakeNode_);
+        lst_.reversed_ = true;
+      }
+    }
+  };
+
+  // Takes all nodes of `other`, which must use an equal allocator; *this must be empty
+  void steal_nodes(list& other);
+  void swap_nodes(list& other);
 
 public:
  
@@ -111,30 +263,413 @@ public:
   list(size_t count, const T& value, const Alloc& allocator = Alloc());
   list(const list& other);
   list(const list& other, const Alloc& allocator);
+  list(list&& other) noexcept;
+  list(list&& other, const Alloc& allocator);
   explicit list(const Alloc& other_alloc);
   explicit list(size_t count, const Alloc& allocator = Alloc());
+  template <std::input_iterator InputIt>
+  list(InputIt first, InputIt last, const Alloc& allocator = Alloc());
+  list(std::initializer_list<T> values, const Alloc& allocator = Alloc());
 
   ~list();
 
   list& operator=(const list& other);
+  list& operator=(list&& other) noexcept(node_traits::propagate_on_container_move_assignment::value
+                                         || node_traits::is_always_equal::value);
+
+  void swap(list& other);
+
+  // Destroys all elements in one pass, their nodes stay cached for reuse
+  void clear() noexcept;
+
+  // Node cache: reserve() makes sure there is memory for `count` elements without
+  // allocating, shrink_to_fit() gives the spare nodes back to the allocator
+  void reserve(size_t count);
+  void shrink_to_fit();
+  size_t capacity() const { return sz_ + (spares_stale() ? 0 : spare_count_); }
 
   void push_back(const T& elem);
+  void push_back(T&& elem);
   void pop_back();
   
   void push_front(const T& elem);
+  void push_front(T&& elem);
   void pop_front(); 
   iterator erase(const_iterator iter);
+  iterator erase(const_iterator first, const_iterator last);
 
-  void reverse();
-
-  const_iterator insert(const_iterator pos, const T& value = T());
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  template <typename... Args>
+  T& emplace_front(Args&&... args);
+
+  // O(1): only flips the orientation, see reversed_. Iterators stay valid, but ones made
+  // before the call keep walking in the old direction, as do ones to elements spliced or
+  // merged in from a list of the other orientation. sort, merge and unique spend O(n) extra
+  // on a reversed list; splicing between lists of opposite orientations costs O(range).
+  void reverse() noexcept { reversed_ = !reversed_; }
+
+  // Stable bottom-up merge sort; nodes are relinked, elements are never moved
+  void sort();
+  template <typename Compare>
+  void sort(Compare cmp);
+  // Sorts sublists on several threads and merges them as a tree, see parallel_sort_policy
+  template <typename Compare = std::less<>>
+  void sort(parallel_sort_policy policy, Compare cmp = Compare());
+
+  // Both lists must be sorted and use equal allocators, `other` ends up empty
+  void merge(list& other);
+  void merge(list&& other);
+  template <typename Compare>
+  void merge(list& other, Compare cmp);
+  template <typename Compare>
+  void merge(list&& other, Compare cmp);
+
+  // Relink nodes of `other` before `pos` in O(1) when the allocators are equal, otherwise the
+  // elements are moved. The range overloads count the range unless its `distance` is given
+  // or `other` is *this.
+  void splice(const_iterator pos, list& other);
+  void splice(const_iterator pos, list&& other);
+  void splice(const_iterator pos, list& other, const_iterator it);
+  void splice(const_iterator pos, list&& other, const_iterator it);
+  void splice(const_iterator pos, list& other, const_iterator first, const_iterator last);
+  void splice(const_iterator pos, list&& other, const_iterator first, const_iterator last);
+  void splice(const_iterator pos, list& other, const_iterator first, const_iterator last,
+              size_t distance);
+
+  // Return the number of removed elements
+  size_t unique();
+  template <typename BinaryPredicate>
+  size_t unique(BinaryPredicate pred);
+  size_t remove(const T& value);
+  template <typename UnaryPredicate>
+  size_t remove_if(UnaryPredicate pred);
+
+  iterator insert(const_iterator pos, const T& value = T());
+  iterator insert(const_iterator pos, T&& value);
   template <typename... Args>
   iterator emplace(const_iterator iter, Args&&... args);
 
+  // Range insertion: nodes are linked in one pass and spliced in all at once
+  iterator insert(const_iterator pos, size_t count, const T& value);
+  template <std::input_iterator InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last);
+  iterator insert(const_iterator pos, std::initializer_list<T> values);
+  template <std::ranges::input_range Range>
+  iterator insert_range(const_iterator pos, Range&& range);
+  template <std::ranges::input_range Range>
+  void append_range(Range&& range);
+  template <std::ranges::input_range Range>
+  void prepend_range(Range&& range);
+
+  void assign(size_t count, const T& value);
+  template <std::input_iterator InputIt>
+  void assign(InputIt first, InputIt last);
+  void assign(std::initializer_list<T> values);
+
   size_t size() const { return sz_; }
   allocator_type get_allocator() const { return alloc_; }
+
+private:
+
+  // Ranges are built in a detached chain and spliced in once every element is
+  // constructed, so a throwing element leaves the list untouched.
+  // `count` is the length of the range if known and only sizes the node block.
+  template <typename InputIt, typename Sentinel>
+  iterator insert_chain(const_iterator pos, InputIt first, Sentinel last, size_t count);
+  template <typename... Args>
+  iterator insert_copies(const_iterator pos, size_t count, const Args&... args);
+  iterator splice_chain(base_pointer pos, BaseNode& chain, size_t count);
+  void destroy_chain(BaseNode& chain);
 };
 
+template <typename T, typename Alloc>
+template <typename... Args>
+auto list<T, Alloc>::create_node(Args&&... args) -> node_pointer {
+  node_pointer new_node = allocate_node();
+  try {
+    node_traits::construct(alloc_, std::to_address(new_node), nullptr, nullptr, std::forward<Args>(args)...);
+  } catch(...) {
+    push_spare(new_node);
+    throw;
+  }
+  return new_node;
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::allocate_node() -> node_pointer {
+  drop_stale_spares();
+  if (spare_ == nullptr) {
+    return node_traits::allocate(alloc_, 1);
+  }
+  spare_pointer node = spare_;
+  spare_ = node->next;
+  --spare_count_;
+  return static_cast<node_pointer>(static_cast<void_pointer>(node));
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::destroy_node(base_pointer node) {
+  node_pointer old_node = static_cast<node_pointer>(node);
+  if constexpr (!kTrivialDestroy) {
+    node_traits::destroy(alloc_, std::to_address(old_node));
+  }
+  push_spare(old_node);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::push_spare(node_pointer node) {
+  drop_stale_spares();
+  if constexpr (kRewindAware) {
+    spare_generation_ = alloc_.rewind_count();
+  }
+  ::new (static_cast<void*>(std::to_address(node))) SpareNode{spare_};
+  if (spare_ == nullptr) {
+    spare_last_ = static_cast<spare_pointer>(static_cast<void_pointer>(node));
+  }
+  spare_ = static_cast<spare_pointer>(static_cast<void_pointer>(node));
+  ++spare_count_;
+}
+
+template <typename T, typename Alloc>
+bool list<T, Alloc>::spares_stale() const {
+  if constexpr (kRewindAware) {
+    return spare_ != nullptr && alloc_.rewind_count() != spare_generation_;
+  } else {
+    return false;
+  }
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::drop_stale_spares() {
+  // The memory may belong to someone else by now, it must not be touched or released
+  if (spares_stale()) {
+    spare_ = nullptr;
+    spare_count_ = 0;
+  }
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::release_spare_nodes() {
+  drop_stale_spares();
+  if constexpr (kChainDeallocation) {
+    if (spare_ != nullptr) {
+      alloc_.deallocate_chain(static_cast<node_pointer>(static_cast<void_pointer>(spare_)),
+                              static_cast<node_pointer>(static_cast<void_pointer>(spare_last_)), spare_count_);
+      spare_ = nullptr;
+    }
+  } else {
+    while (spare_ != nullptr) {
+      spare_pointer next = spare_->next;
+      node_traits::deallocate(alloc_, static_cast<node_pointer>(static_cast<void_pointer>(spare_)), 1);
+      spare_ = next;
+    }
+  }
+  spare_count_ = 0;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::reserve(size_t count) {
+  if (count > sz_) {
+    reserve_spares(count - sz_);
+  }
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::reserve_spares(size_t count) {
+  drop_stale_spares();
+  if (spare_count_ >= count) {
+    return;
+  }
+
+  size_t missing = count - spare_count_;
+  if constexpr (kBulkNodeAllocation) {
+    // Pushed back to front, so the nodes are handed out in address order
+    node_pointer block = node_traits::allocate(alloc_, missing);
+    for (size_t i = missing; i != 0; --i) {
+      push_spare(block + (i - 1));
+    }
+  } else {
+    for (size_t i = 0; i < missing; ++i) {
+      push_spare(node_traits::allocate(alloc_, 1));
+    }
+  }
+}
+
+template <typename T, typename Alloc>
+template <typename InputIt, typename Sentinel>
+auto list<T, Alloc>::insert_chain(const_iterator pos, InputIt first, Sentinel last, size_t count)
+                                  -> iterator {
+  if constexpr (kBulkNodeAllocation) {
+    reserve_spares(count);
+  }
+
+  BaseNode chain{ &chain, &chain };
+  size_t built = 0;
+  try {
+    for (; first != last; ++first) {
+      link_before(&chain, create_node(*first));
+      ++built;
+    }
+  } catch(...) {
+    destroy_chain(chain);
+    throw;
+  }
+  return splice_chain(pos.ptr, chain, built);
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+auto list<T, Alloc>::insert_copies(const_iterator pos, size_t count, const Args&... args)
+                                   -> iterator {
+  if constexpr (kBulkNodeAllocation) {
+    reserve_spares(count);
+  }
+
+  BaseNode chain{ &chain, &chain };
+  try {
+    for (size_t i = 0; i < count; ++i) {
+      link_before(&chain, create_node(args...));
+    }
+  } catch(...) {
+    destroy_chain(chain);
+    throw;
+  }
+  return splice_chain(pos.ptr, chain, count);
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::splice_chain(base_pointer pos, BaseNode& chain, size_t count) -> iterator {
+  if (count == 0) {
+    return { pos, reversed_ };
+  }
+
+  // The chain is built front to back, a reversed list takes it back to front
+  if (reversed_) {
+    swap_links(chain);
+    pos = pos->next;
+  }
+  base_pointer first = chain.next;
+  base_pointer last = chain.prev;
+  first->prev = pos->prev;
+  last->next = pos;
+  pos->prev->next = first;
+  pos->prev = last;
+  sz_ += count;
+  return { reversed_ ? last : first, reversed_ };
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::destroy_chain(BaseNode& chain) {
+  base_pointer node = chain.next;
+  while (node != &chain) {
+    base_pointer next = node->next;
+    destroy_node(node);
+    node = next;
+  }
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::shrink_to_fit() {
+  release_spare_nodes();
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::link_before(base_pointer pos, base_pointer node) {
+  node->next = pos;
+  node->prev = pos->prev;
+  pos->prev->next = node;
+  pos->prev = node;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::unlink(base_pointer node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::transfer(base_pointer pos, base_pointer first, base_pointer last) {
+  if (first == last || pos == last) {
+    return;
+  }
+
+  base_pointer last_node = last->prev;
+  first->prev->next = last;
+  last->prev = first->prev;
+
+  first->prev = pos->prev;
+  last_node->next = pos;
+  pos->prev->next = first;
+  pos->prev = last_node;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::swap_links(BaseNode& sentinel) {
+  base_pointer node = &sentinel;
+  do {
+    using std::swap;
+    swap(node->next, node->prev);
+    node = node->prev;
+  } while (node != &sentinel);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::transfer_from(const list& from, base_pointer pos, base_pointer first,
+                                   base_pointer last) {
+  // Splicing a range before its own end is a no-op, and the translation below would lose it
+  if (first == last || pos == last) {
+    return;
+  }
+  if (from.reversed_) {
+    // Logically first..last runs along prev links: physically it is [last->next, first->next)
+    base_pointer physical_first = last->next;
+    last = first->next;
+    first = physical_first;
+  }
+  pos = link_position(pos);
+  if (from.reversed_ == reversed_) {
+    transfer(pos, first, last);
+    return;
+  }
+
+  // Detach the range and flip it to match this list
+  if (first == last) {
+    return;
+  }
+  BaseNode chain{ &chain, &chain };
+  transfer(&chain, first, last);
+  swap_links(chain);
+  transfer(pos, chain.next, &chain);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::steal_nodes(list& other) {
+  reversed_ = std::exchange(other.reversed_, false);
+  take_region_depth(other);
+  if (other.sz_ == 0) {
+    return;
+  }
+
+  fakeNode_.next = other.fakeNode_.next;
+  fakeNode_.prev = other.fakeNode_.prev;
+  fakeNode_.next->prev = &fakeNode_;
+  fakeNode_.prev->next = &fakeNode_;
+  sz_ = other.sz_;
+
+  other.fakeNode_.next = &other.fakeNode_;
+  other.fakeNode_.prev = &other.fakeNode_;
+  other.sz_ = 0;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::swap_nodes(list& other) {
+  list temp(alloc_);
+  temp.steal_nodes(*this);
+  steal_nodes(other);
+  other.steal_nodes(temp);
+}
+
 template <typename T, typename Alloc>
 list<T, Alloc>::list(const Alloc& allocator) 
               : fakeNode_{ &fakeNode_, &fakeNode_ },
@@ -147,16 +682,10 @@ list<T, Alloc>::list(size_t count, const T& value, const Alloc& allocator)
     : fakeNode_{ &fakeNode_, &fakeNode_ },
       alloc_(allocator),
       sz_(0) {
-  
-  size_t count_of_nodes_;
   try {
-    for (count_of_nodes_ = 0; count_of_nodes_ < count; ++count_of_nodes_) {
-      emplace(begin(), value);
-    }
+    insert_copies(end(), count, value);
   } catch(...) {
-    for (size_t i = 0; i < count_of_nodes_; ++i) {
-      pop_back();
-    }
+    release_spare_nodes();
     throw;
   }
 }
@@ -166,16 +695,10 @@ list<T, Alloc>::list(const list& other, const Alloc& allocator)
               : fakeNode_{ &fakeNode_, &fakeNode_ },
                 alloc_(allocator),
                 sz_(0) {
-  size_t count_of_nodes_ = 0;
   try {
-    for(const auto& elem : other) {
-      emplace(begin(), elem);
-      count_of_nodes_++;
-    }
+    insert_chain(end(), other.begin(), other.end(), other.sz_);
   } catch(...) {
-    for (size_t i = 0; i < count_of_nodes_; ++i) {
-      pop_back();
-    }
+    release_spare_nodes();
     throw;
   }
 }
@@ -186,129 +709,270 @@ list<T, Alloc>::list(const list& other)
                 alloc_(std::allocator_traits<node_allocator>
                           ::select_on_container_copy_construction(other.get_allocator())),
                 sz_(0) {
-  size_t count_of_nodes_ = 0;
   try {
-    for (const auto& elem : other) {
-      emplace(end(), elem);
-      count_of_nodes_++;
-    }
+    insert_chain(end(), other.begin(), other.end(), other.sz_);
   } catch(...) {
-    for (size_t i = 0; i < count_of_nodes_; ++i) {
-      pop_back();
-    }
+    release_spare_nodes();
     throw;
   }
 }
 
 template <typename T, typename Alloc>
-list<T, Alloc>::list(size_t count, const Alloc& allocator)
+list<T, Alloc>::list(list&& other) noexcept
               : fakeNode_{ &fakeNode_, &fakeNode_ },
-                alloc_(allocator), 
+                alloc_(other.alloc_),
                 sz_(0) {
-  size_t count_of_nodes_;
+  steal_nodes(other);
+}
+
+template <typename T, typename Alloc>
+list<T, Alloc>::list(list&& other, const Alloc& allocator)
+              : fakeNode_{ &fakeNode_, &fakeNode_ },
+                alloc_(allocator),
+                sz_(0) {
+  if (alloc_ == other.alloc_) {
+    steal_nodes(other);
+    return;
+  }
+
+  // Nodes cannot change hands between unequal allocators, move the elements instead
   try {
-    for (count_of_nodes_ = 0; count_of_nodes_ < count; count_of_nodes_++) {
-      emplace(begin());
+    for (auto& elem : other) {
+      emplace(end(), std::move(elem));
     }
   } catch(...) {
-    for (size_t i = 0; i < count_of_nodes_; ++i) {
-      pop_back();
-    }
+    clear();
+    release_spare_nodes();
     throw;
   }
 }
 
 template <typename T, typename Alloc>
-list<T, Alloc>::~list() {
-  size_t old_sz_ = sz_;
-  for (size_t i = 0; i < old_sz_; ++i) {
-    pop_back();
+list<T, Alloc>::list(size_t count, const Alloc& allocator)
+              : fakeNode_{ &fakeNode_, &fakeNode_ },
+                alloc_(allocator), 
+                sz_(0) {
+  try {
+    insert_copies(end(), count);
+  } catch(...) {
+    release_spare_nodes();
+    throw;
   }
 }
 
-template<typename T, typename Alloc>
-list<T, Alloc>& list<T, Alloc>::operator=(const list& other) {
-  list<T, Alloc> temp_list(other, other.alloc_);
-  swap(temp_list);
-  return *this;
+template <typename T, typename Alloc>
+template <std::input_iterator InputIt>
+list<T, Alloc>::list(InputIt first, InputIt last, const Alloc& allocator)
+              : fakeNode_{ &fakeNode_, &fakeNode_ },
+                alloc_(allocator),
+                sz_(0) {
+  try {
+    insert(end(), first, last);
+  } catch(...) {
+    release_spare_nodes();
+    throw;
+  }
 }
 
 template <typename T, typename Alloc>
-void list<T, Alloc>::push_back(const T& elem) {
-  Node* new_node = std::allocator_traits<node_allocator>::allocate(alloc_, 1);
+list<T, Alloc>::list(std::initializer_list<T> values, const Alloc& allocator)
+              : fakeNode_{ &fakeNode_, &fakeNode_ },
+                alloc_(allocator),
+                sz_(0) {
   try {
-    std::allocator_traits<node_allocator>::construct(alloc_, new_node, &fakeNode_, nullptr, elem);
+    insert(end(), values);
   } catch(...) {
-    std::allocator_traits<node_allocator>::deallocate(alloc_, new_node, 1);
+    release_spare_nodes();
     throw;
   }
+}
 
-  if (sz_ == 0) {
-    fakeNode_.next = new_node;
-    fakeNode_.prev = new_node;
+template <typename T, typename Alloc>
+list<T, Alloc>::~list() {
+  if constexpr (kRegionAware) {
+    // The innermost region predates every node and is going to rewind them all
+    if (region_depth_ != 0 && alloc_.region_depth() == region_depth_) {
+      return;
+    }
+  }
+
+  if constexpr (kChainDeallocation) {
+    // A single walk destroys the elements and stacks the nodes onto the spare chain, so
+    // the newest node leads it, then the whole chain goes back in one call
+    drop_stale_spares();
+    if (sz_ == 0 && spare_ == nullptr) {
+      return;
+    }
+    spare_pointer chain = spare_;
+    spare_pointer chain_last = spare_ != nullptr ? spare_last_ : nullptr;
+    base_pointer node = fakeNode_.next;
+    while (node != &fakeNode_) {
+      base_pointer next = node->next;
+      node_pointer old_node = static_cast<node_pointer>(node);
+      if constexpr (!kTrivialDestroy) {
+        node_traits::destroy(alloc_, std::to_address(old_node));
+      }
+      ::new (static_cast<void*>(std::to_address(old_node))) SpareNode{chain};
+      chain = static_cast<spare_pointer>(static_cast<void_pointer>(old_node));
+      if (chain_last == nullptr) {
+        chain_last = chain;
+      }
+      node = next;
+    }
+    alloc_.deallocate_chain(static_cast<node_pointer>(static_cast<void_pointer>(chain)),
+                            static_cast<node_pointer>(static_cast<void_pointer>(chain_last)),
+                            sz_ + spare_count_);
   } else {
-    fakeNode_.prev->next = new_node;
-    new_node->prev = fakeNode_.prev;
-    fakeNode_.prev = new_node;
+    base_pointer node = fakeNode_.next;
+    while (node != &fakeNode_) {
+      base_pointer next = node->next;
+      node_pointer old_node = static_cast<node_pointer>(node);
+      if constexpr (!kTrivialDestroy) {
+        node_traits::destroy(alloc_, std::to_address(old_node));
+      }
+      node_traits::deallocate(alloc_, old_node, 1);
+      node = next;
+    }
+    release_spare_nodes();
   }
-  ++sz_;
 }
 
 template <typename T, typename Alloc>
-void list<T, Alloc>::push_front(const T& elem) {
-  Node* new_node = std::allocator_traits<node_allocator>::allocate(alloc_, 1);
-  try {
-    std::allocator_traits<node_allocator>::construct(alloc_, new_node, nullptr, nullptr, elem);
-  } catch(...) {
-    std::allocator_traits<node_allocator>::deallocate(alloc_, new_node, 1);
-    throw;
+void list<T, Alloc>::clear() noexcept {
+  base_pointer node = fakeNode_.next;
+  while (node != &fakeNode_) {
+    base_pointer next = node->next;
+    destroy_node(node);
+    node = next;
+  }
+  fakeNode_.next = &fakeNode_;
+  fakeNode_.prev = &fakeNode_;
+  sz_ = 0;
+  reversed_ = false;
+}
+
+template<typename T, typename Alloc>
+list<T, Alloc>& list<T, Alloc>::operator=(const list& other) {
+  if (this == &other) {
+    return *this;
   }
 
-  if (sz_ == 0) {
-    fakeNode_.next = new_node;
-    fakeNode_.prev = new_node;
-    new_node->next = &fakeNode_;
+  if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+    // Nodes of the old allocator cannot be reused with the new one
+    if (!(alloc_ == other.alloc_)) {
+      clear();
+      release_spare_nodes();
+      region_depth_ = region_depth_of(other.alloc_);
+    }
+    alloc_ = other.alloc_;
+  }
+
+  // Reuse existing nodes element-wise, then grow or shrink the tail
+  iterator it = begin();
+  const_iterator other_it = other.begin();
+  if constexpr (std::is_copy_assignable_v<T>) {
+    for (; it != end() && other_it != other.end(); ++it, ++other_it) {
+      *it = *other_it;
+    }
+  }
+  erase(it, end());
+  insert_chain(end(), other_it, other.end(), other.sz_ - sz_);
+  return *this;
+}
+
+template<typename T, typename Alloc>
+list<T, Alloc>& list<T, Alloc>::operator=(list&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value
+             || node_traits::is_always_equal::value) {
+  if (this == &other) {
+    return *this;
+  }
+
+  constexpr bool propagate = node_traits::propagate_on_container_move_assignment::value;
+  if (propagate || alloc_ == other.alloc_) {
+    clear();
+    if constexpr (propagate) {
+      if (!(alloc_ == other.alloc_)) {
+        release_spare_nodes();
+        region_depth_ = region_depth_of(other.alloc_);
+      }
+      alloc_ = other.alloc_;
+    }
+    steal_nodes(other);
   } else {
-    fakeNode_.next->prev = new_node;
-    new_node->next = fakeNode_.next;
-    fakeNode_.next = new_node;
+    list<T, Alloc> temp_list(std::move(other), alloc_);
+    swap_nodes(temp_list);
+  }
+  return *this;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::swap(list& other) {
+  swap_nodes(other);
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    using std::swap;
+    // Depths of different storages cannot be compared, never skip releasing then
+    if (!(alloc_ == other.alloc_)) {
+      region_depth_ = 0;
+      other.region_depth_ = 0;
+    }
+    swap(alloc_, other.alloc_);
+    swap(spare_, other.spare_);
+    swap(spare_last_, other.spare_last_);
+    swap(spare_count_, other.spare_count_);
+    swap(spare_generation_, other.spare_generation_);
   }
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+T& list<T, Alloc>::emplace_back(Args&&... args) {
+  return *emplace(end(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc>
+template <typename... Args>
+T& list<T, Alloc>::emplace_front(Args&&... args) {
+  return *emplace(begin(), std::forward<Args>(args)...);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::push_back(const T& elem) {
+  link_before(link_position(&fakeNode_), create_node(elem));
   ++sz_;
 }
 
 template <typename T, typename Alloc>
-void list<T, Alloc>::pop_back() {
+void list<T, Alloc>::push_back(T&& elem) {
+  link_before(link_position(&fakeNode_), create_node(std::move(elem)));
+  ++sz_;
+}
 
-  Node* prev_before_last_elem = static_cast<Node*>(fakeNode_.prev->prev);
-  std::allocator_traits<node_allocator>::destroy(alloc_, static_cast<Node*>(fakeNode_.prev));
-  std::allocator_traits<node_allocator>::deallocate(alloc_, static_cast<Node*>(fakeNode_.prev), 1);
+template <typename T, typename Alloc>
+void list<T, Alloc>::push_front(const T& elem) {
+  link_before(reversed_ ? &fakeNode_ : fakeNode_.next, create_node(elem));
+  ++sz_;
+}
 
-  if (sz_ == 1) {
-    fakeNode_.next = &fakeNode_;
-    fakeNode_.prev = &fakeNode_;
-  } else {
-    fakeNode_.prev = prev_before_last_elem;
-    prev_before_last_elem->next = &fakeNode_;
-  }
+template <typename T, typename Alloc>
+void list<T, Alloc>::push_front(T&& elem) {
+  link_before(reversed_ ? &fakeNode_ : fakeNode_.next, create_node(std::move(elem)));
+  ++sz_;
+}
 
+template <typename T, typename Alloc>
+void list<T, Alloc>::pop_back() {
+  base_pointer last = reversed_ ? fakeNode_.next : fakeNode_.prev;
+  unlink(last);
+  destroy_node(last);
   sz_--;
 }
 
 template <typename T, typename Alloc>
 void list<T, Alloc>::pop_front() {
-
-  Node* second_element = static_cast<Node*>(fakeNode_.next->next);
-  std::allocator_traits<node_allocator>::destroy(alloc_, static_cast<Node*>(fakeNode_.next));
-  std::allocator_traits<node_allocator>::deallocate(alloc_, static_cast<Node*>(fakeNode_.next), 1);
-  
-  if (sz_ == 1) {
-    fakeNode_.next = &fakeNode_;
-    fakeNode_.prev = &fakeNode_;
-  } else {
-    fakeNode_.next = second_element;
-    second_element->prev = nullptr;
-  }
-
+  base_pointer first = reversed_ ? fakeNode_.prev : fakeNode_.next;
+  unlink(first);
+  destroy_node(first);
   sz_--;
 }
 
@@ -319,100 +983,541 @@ auto list<T, Alloc>::erase(typename list<T, Alloc>::const_iterator iter)
     return this->end();
   }
 
-  if (iter.ptr->prev != nullptr) {
-    iter.ptr->prev->next = iter.ptr->next;
-    iter.ptr->next->prev = iter.ptr->prev;
-  } else {
-   fakeNode_.next = iter.ptr->next;
-   iter.ptr->next->prev = nullptr;
-  }
-
-  iterator result = iter.ptr->next;
-  std::allocator_traits<node_allocator>::destroy(alloc_, static_cast<Node*>(iter.ptr));
-  std::allocator_traits<node_allocator>::deallocate(alloc_, static_cast<Node*>(iter.ptr), 1);
+  iterator result = std::next(iterator(iter.ptr, reversed_));
+  unlink(iter.ptr);
+  destroy_node(iter.ptr);
 
   sz_--;
   return result;
 }
 
+template <typename T, typename Alloc>
+auto list<T, Alloc>::erase(const_iterator first, const_iterator last) -> iterator {
+  while (first != last) {
+    first = erase(first);
+  }
+  return { last.ptr, reversed_ };
+}
+
 template <typename T, typename Alloc>
 template <typename... Args>
 auto list<T, Alloc>::emplace(list<T, Alloc>::const_iterator iter, Args&&... args) 
                    -> list<T, Alloc>::iterator{
-  Node* new_node = std::allocator_traits<node_allocator>::allocate(alloc_, 1);
+  node_pointer new_node = create_node(std::forward<Args>(args)...);
+  link_before(link_position(iter.ptr), new_node);
+  sz_++;
+
+  return { new_node, reversed_ };
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::insert(const_iterator pos, const T& value)
+                            -> list<T, Alloc>::iterator {
+  return emplace(pos, value);
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::insert(const_iterator pos, T&& value)
+                            -> list<T, Alloc>::iterator {
+  return emplace(pos, std::move(value));
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::insert(const_iterator pos, size_t count, const T& value)
+                            -> list<T, Alloc>::iterator {
+  return insert_copies(pos, count, value);
+}
+
+template <typename T, typename Alloc>
+template <std::input_iterator InputIt>
+auto list<T, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
+                            -> list<T, Alloc>::iterator {
+  size_t count = 0;
+  if constexpr (kBulkNodeAllocation && std::forward_iterator<InputIt>) {
+    count = std::distance(first, last);
+  }
+  return insert_chain(pos, first, last, count);
+}
+
+template <typename T, typename Alloc>
+auto list<T, Alloc>::insert(const_iterator pos, std::initializer_list<T> values)
+                            -> list<T, Alloc>::iterator {
+  return insert_chain(pos, values.begin(), values.end(), values.size());
+}
+
+template <typename T, typename Alloc>
+template <std::ranges::input_range Range>
+auto list<T, Alloc>::insert_range(const_iterator pos, Range&& range)
+                                  -> list<T, Alloc>::iterator {
+  size_t count = 0;
+  if constexpr (std::ranges::sized_range<Range>) {
+    count = std::ranges::size(range);
+  } else if constexpr (kBulkNodeAllocation && std::ranges::forward_range<Range>) {
+    count = std::ranges::distance(range);
+  }
+  return insert_chain(pos, std::ranges::begin(range), std::ranges::end(range), count);
+}
+
+template <typename T, typename Alloc>
+template <std::ranges::input_range Range>
+void list<T, Alloc>::append_range(Range&& range) {
+  insert_range(cend(), std::forward<Range>(range));
+}
+
+template <typename T, typename Alloc>
+template <std::ranges::input_range Range>
+void list<T, Alloc>::prepend_range(Range&& range) {
+  insert_range(cbegin(), std::forward<Range>(range));
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::assign(size_t count, const T& value) {
+  iterator it = begin();
+  for (; it != end() && count != 0; ++it, --count) {
+    *it = value;
+  }
+  erase(it, end());
+  insert_copies(end(), count, value);
+}
+
+template <typename T, typename Alloc>
+template <std::input_iterator InputIt>
+void list<T, Alloc>::assign(InputIt first, InputIt last) {
+  iterator it = begin();
+  for (; it != end() && first != last; ++it, ++first) {
+    *it = *first;
+  }
+  erase(it, end());
+  insert(end(), first, last);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::assign(std::initializer_list<T> values) {
+  assign(values.begin(), values.end());
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::merge_chains(base_pointer& into, base_pointer& from, Compare& cmp) {
+  BaseNode head{ nullptr, nullptr };
+  base_pointer tail = &head;
+  base_pointer first = into;
+  base_pointer second = from;
+  base_pointer first_last = first->prev;
+  base_pointer second_last = second->prev;
   try {
-    std::allocator_traits<node_allocator>::construct(alloc_, new_node, iter.ptr, nullptr, std::forward<Args>(args)...);
+    // prev links are fixed while the nodes are hot anyway, so no extra pass is needed
+    while (first != nullptr && second != nullptr) {
+      if (cmp(value_of(second), value_of(first))) {
+        tail->next = second;
+        second->prev = tail;
+        second = second->next;
+      } else {
+        tail->next = first;
+        first->prev = tail;
+        first = first->next;
+      }
+      tail = tail->next;
+    }
   } catch(...) {
-    std::allocator_traits<node_allocator>::deallocate(alloc_, new_node, 1);
+    // Keep every node reachable, the order no longer matters
+    tail->next = first;
+    while (tail->next != nullptr) {
+      tail = tail->next;
+    }
+    tail->next = second;
+    into = head.next;
+    from = nullptr;
     throw;
   }
 
-  if (sz_ == 0) {
-    fakeNode_.next = new_node;
-    fakeNode_.prev = new_node;
-  } else if (iter.ptr->prev == nullptr) {
-    iter.ptr->prev = new_node;
-    fakeNode_.next = new_node;
-  } else {
-    iter.ptr->prev->next = new_node;
-    new_node->prev = iter.ptr->prev;
-    iter.ptr->prev = new_node;
+  base_pointer rest = (first != nullptr ? first : second);
+  tail->next = rest;
+  rest->prev = tail;
+  into = head.next;
+  into->prev = (first != nullptr ? first_last : second_last);
+  from = nullptr;
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::adopt_chain(base_pointer first) {
+  base_pointer prev = &fakeNode_;
+  for (base_pointer node = first; node != nullptr; node = node->next) {
+    node->prev = prev;
+    prev->next = node;
+    prev = node;
   }
+  prev->next = &fakeNode_;
+  fakeNode_.prev = prev;
+}
 
-  sz_++;
+template <typename T, typename Alloc>
+void list<T, Alloc>::sort() {
+  sort(std::less<>());
+}
 
-  return { new_node };
+template <typename T, typename Alloc>
+void list<T, Alloc>::prepend_chain(base_pointer& chain, base_pointer piece) {
+  if (piece == nullptr) {
+    return;
+  }
+  base_pointer tail = piece;
+  while (tail->next != nullptr) {
+    tail = tail->next;
+  }
+  tail->next = chain;
+  chain = piece;
 }
 
 template <typename T, typename Alloc>
-auto list<T, Alloc>::insert(const_iterator pos, const T& value)
-                            -> list<T, Alloc>::const_iterator {
-  Node* new_node = std::allocator_traits<node_allocator>::allocate(alloc_, 1);
+void list<T, Alloc>::adopt_sorted_chain(base_pointer first) {
+  base_pointer last = first->prev;
+  fakeNode_.next = first;
+  first->prev = &fakeNode_;
+  fakeNode_.prev = last;
+  last->next = &fakeNode_;
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::sort_chain(base_pointer& chain, Compare& cmp) {
+  // bins[i] is either empty or a sorted run of 2^i nodes, older runs in higher bins
+  constexpr size_t kBins = 64;
+  base_pointer bins[kBins] = {};
+  base_pointer run = nullptr;
+  base_pointer rest = chain;
+
   try {
-    std::allocator_traits<node_allocator>::construct(alloc_, new_node, pos.ptr, pos.ptr->prev, value);
+    while (rest != nullptr) {
+      run = rest;
+      rest = rest->next;
+      run->next = nullptr;
+      run->prev = run;
+
+      size_t i = 0;
+      for (; bins[i] != nullptr; ++i) {
+        merge_chains(bins[i], run, cmp);
+        run = std::exchange(bins[i], nullptr);
+      }
+      bins[i] = std::exchange(run, nullptr);
+    }
+
+    for (size_t i = 0; i < kBins; ++i) {
+      if (bins[i] == nullptr) {
+        continue;
+      }
+      if (run != nullptr) {
+        merge_chains(bins[i], run, cmp);
+      }
+      run = std::exchange(bins[i], nullptr);
+    }
   } catch(...) {
-    std::allocator_traits<node_allocator>::deallocate(alloc_, new_node, 1);
+    // Gather the pieces back into one chain in unspecified order
+    chain = rest;
+    prepend_chain(chain, run);
+    for (base_pointer bin : bins) {
+      prepend_chain(chain, bin);
+    }
     throw;
   }
+  chain = run;
+}
 
-  if (new_node->prev != nullptr) {
-    pos.ptr->prev->next = new_node;
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::sort(Compare cmp) {
+  if (sz_ < 2) {
+    return;
   }
 
-  pos.ptr->prev = new_node;
+  ForwardLinks forward(*this);
+  base_pointer chain = fakeNode_.next;
+  fakeNode_.prev->next = nullptr;
+  try {
+    sort_chain(chain, cmp);
+  } catch(...) {
+    adopt_chain(chain);
+    throw;
+  }
+  adopt_sorted_chain(chain);
+}
 
-  sz_++;
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::sort(parallel_sort_policy policy, Compare cmp) {
+  size_t threads = policy.threads != 0 ? policy.threads : std::thread::hardware_concurrency();
+  threads = std::min(threads, sz_ / parallel_sort_policy::kMinNodesPerThread);
+  if (threads < 2) {
+    sort(std::move(cmp));
+    return;
+  }
+  ForwardLinks forward(*this);
+
+  // Cut the list into `threads` chains of nearly equal length
+  std::vector<base_pointer> chains(threads);
+  base_pointer node = fakeNode_.next;
+  fakeNode_.prev->next = nullptr;
+  for (size_t i = 0; i < threads; ++i) {
+    chains[i] = node;
+    size_t length = sz_ / threads + (i < sz_ % threads ? 1 : 0);
+    for (size_t j = 1; j < length; ++j) {
+      node = node->next;
+    }
+    base_pointer next = node->next;
+    node->next = nullptr;
+    node = next;
+  }
 
-  return { new_node };
+  // Runs task(0), ..., task(count - 1) on separate threads, the first one on this thread.
+  // Every chain stays reachable from `chains` whatever the tasks throw.
+  std::vector<std::exception_ptr> errors(threads);
+  auto run_tasks = [&errors](size_t count, auto task) {
+    auto guarded = [&errors, &task](size_t i) {
+      try {
+        task(i);
+      } catch(...) {
+        errors[i] = std::current_exception();
+      }
+    };
+    std::vector<std::thread> workers;
+    workers.reserve(count - 1);
+    for (size_t i = 1; i < count; ++i) {
+      try {
+        workers.emplace_back(guarded, i);
+      } catch(...) {
+        guarded(i);
+      }
+    }
+    guarded(0);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+  };
+  auto rethrow_if_failed = [this, &chains, &errors]() {
+    auto failed = std::find_if(errors.begin(), errors.end(),
+                               [](const std::exception_ptr& error) { return error != nullptr; });
+    if (failed == errors.end()) {
+      return;
+    }
+    base_pointer chain = nullptr;
+    for (base_pointer piece : chains) {
+      prepend_chain(chain, piece);
+    }
+    adopt_chain(chain);
+    std::rethrow_exception(*failed);
+  };
+
+  run_tasks(threads, [&chains, &cmp](size_t i) {
+    Compare local_cmp = cmp;
+    sort_chain(chains[i], local_cmp);
+  });
+  rethrow_if_failed();
+
+  // Merge neighbours pairwise as a tree; the left chain wins ties, which keeps the sort stable
+  for (size_t step = 1; step < threads; step *= 2) {
+    size_t pairs = (threads + step - 1) / (2 * step);
+    run_tasks(pairs, [&chains, &cmp, step](size_t pair) {
+      size_t left = pair * 2 * step;
+      Compare local_cmp = cmp;
+      merge_chains(chains[left], chains[left + step], local_cmp);
+    });
+    rethrow_if_failed();
+  }
+  adopt_sorted_chain(chains[0]);
 }
 
 template <typename T, typename Alloc>
-void list<T, Alloc>::swap(list<T, Alloc>& other) {
-  using std::swap;
-  swap(fakeNode_, other.fakeNode_);
-  swap(sz_, other.sz_);
-  if (std::allocator_traits<node_allocator>::propagate_on_container_copy_assignment::value) {
-    swap(alloc_, other.alloc_);
+void list<T, Alloc>::merge(list& other) {
+  merge(other, std::less<>());
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::merge(list&& other) {
+  merge(other, std::less<>());
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::merge(list&& other, Compare cmp) {
+  merge(other, std::move(cmp));
+}
+
+template <typename T, typename Alloc>
+template <typename Compare>
+void list<T, Alloc>::merge(list& other, Compare cmp) {
+  if (this == &other) {
+    return;
+  }
+
+  ForwardLinks forward(*this);
+  ForwardLinks other_forward(other);
+  take_region_depth(other);
+  base_pointer pos = fakeNode_.next;
+  while (other.sz_ != 0) {
+    if (pos == &fakeNode_) {
+      // Whatever is left in `other` goes to the end in one piece
+      splice_chain(pos, other.fakeNode_, other.sz_);
+      other.fakeNode_.next = &other.fakeNode_;
+      other.fakeNode_.prev = &other.fakeNode_;
+      other.sz_ = 0;
+      return;
+    }
+
+    base_pointer node = other.fakeNode_.next;
+    if (cmp(value_of(node), value_of(pos))) {
+      unlink(node);
+      --other.sz_;
+      link_before(pos, node);
+      ++sz_;
+    } else {
+      pos = pos->next;
+    }
+  }
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& other) {
+  splice(pos, other, other.cbegin(), other.cend(), other.sz_);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list&& other) {
+  splice(pos, other);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& other, const_iterator it) {
+  const_iterator next(other.reversed_ ? it.ptr->prev : it.ptr->next, other.reversed_);
+  if (pos == it || pos == next) {
+    return;
+  }
+  splice(pos, other, it, next, 1);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list&& other, const_iterator it) {
+  splice(pos, other, it);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& other,
+                            const_iterator first, const_iterator last) {
+  size_t distance = 0;
+  if (this != &other) {
+    distance = std::distance(first, last);
+  }
+  splice(pos, other, first, last, distance);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list&& other,
+                            const_iterator first, const_iterator last) {
+  splice(pos, other, first, last);
+}
+
+template <typename T, typename Alloc>
+void list<T, Alloc>::splice(const_iterator pos, list& other,
+                            const_iterator first, const_iterator last, size_t distance) {
+  if (this == &other) {
+    transfer_from(other, pos.ptr, first.ptr, last.ptr);
+    return;
+  }
+
+  if (alloc_ == other.alloc_) {
+    take_region_depth(other);
+    transfer_from(other, pos.ptr, first.ptr, last.ptr);
+    sz_ += distance;
+    other.sz_ -= distance;
+    return;
+  }
+
+  // Nodes cannot change hands between unequal allocators
+  insert_chain(pos, std::make_move_iterator(iterator(first.ptr, other.reversed_)),
+               std::make_move_iterator(iterator(last.ptr, other.reversed_)), distance);
+  other.erase(first, last);
+}
+
+template <typename T, typename Alloc>
+size_t list<T, Alloc>::unique() {
+  return unique(std::equal_to<>());
+}
+
+template <typename T, typename Alloc>
+template <typename BinaryPredicate>
+size_t list<T, Alloc>::unique(BinaryPredicate pred) {
+  ForwardLinks forward(*this);
+  // Removed nodes are parked in a chain and destroyed at the end
+  BaseNode removed{ &removed, &removed };
+  size_t count = 0;
+  try {
+    base_pointer kept = fakeNode_.next;
+    while (kept != &fakeNode_ && kept->next != &fakeNode_) {
+      base_pointer node = kept->next;
+      if (pred(value_of(kept), value_of(node))) {
+        unlink(node);
+        link_before(&removed, node);
+        --sz_;
+        ++count;
+      } else {
+        kept = node;
+      }
+    }
+  } catch(...) {
+    destroy_chain(removed);
+    throw;
+  }
+  destroy_chain(removed);
+  return count;
+}
+
+template <typename T, typename Alloc>
+size_t list<T, Alloc>::remove(const T& value) {
+  // `value` may live in one of the removed nodes, which are destroyed only at the end
+  return remove_if([&value](const T& elem) { return elem == value; });
+}
+
+template <typename T, typename Alloc>
+template <typename UnaryPredicate>
+size_t list<T, Alloc>::remove_if(UnaryPredicate pred) {
+  BaseNode removed{ &removed, &removed };
+  size_t count = 0;
+  try {
+    base_pointer node = fakeNode_.next;
+    while (node != &fakeNode_) {
+      base_pointer next = node->next;
+      if (pred(value_of(node))) {
+        unlink(node);
+        link_before(&removed, node);
+        --sz_;
+        ++count;
+      }
+      node = next;
+    }
+  } catch(...) {
+    destroy_chain(removed);
+    throw;
   }
+  destroy_chain(removed);
+  return count;
 }
 
 // BEGIN
 template <typename T, typename Alloc>
 auto list<T, Alloc>::begin()
           -> typename list<T, Alloc>::iterator {
-  return { static_cast<Node*>(fakeNode_.next) };
+  return { reversed_ ? fakeNode_.prev : fakeNode_.next, reversed_ };
 }
 
 template <typename T, typename Alloc>
 auto list<T, Alloc>::begin() const 
           -> typename list<T, Alloc>::const_iterator {
-  return { fakeNode_.next };
+  return { reversed_ ? fakeNode_.prev : fakeNode_.next, reversed_ };
 }
 
 template <typename T, typename Alloc>
 auto list<T, Alloc>::cbegin() const
           -> typename list<T, Alloc>::const_iterator {
-  return { fakeNode_.next };
+  return { reversed_ ? fakeNode_.prev : fakeNode_.next, reversed_ };
 }
 
 
@@ -420,19 +1525,19 @@ auto list<T, Alloc>::cbegin() const
 template <typename T, typename Alloc>
 auto list<T, Alloc>::end()
           -> typename list<T, Alloc>::iterator {
-  return { &fakeNode_ };
+  return { &fakeNode_, reversed_ };
 }
 
 template <typename T, typename Alloc>
 auto list<T, Alloc>::end() const 
           -> typename list<T, Alloc>::const_iterator {
-  return { &fakeNode_ };
+  return { &fakeNode_, reversed_ };
 }
 
 template <typename T, typename Alloc>
 auto list<T, Alloc>::cend() const
           -> typename list<T, Alloc>::const_iterator {
-  return { &fakeNode_ };
+  return { &fakeNode_, reversed_ };
 }
 
 // RBEGIN
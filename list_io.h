@@ -0,0 +1,129 @@
+#pragma once
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "list.h"
+
+// Flat binary form of a list of trivially copyable elements: this header, then the
+// elements back to back in list order
+struct ListBinaryHeader {
+  uint64_t count;
+  uint64_t element_size;
+};
+
+// Writes all of `parts`, resuming after partial writes
+inline void writev_fully(int fd, std::vector<iovec>& parts) {
+  iovec* part = parts.data();
+  size_t left = parts.size();
+  while (left != 0) {
+    ssize_t written = writev(fd, part, static_cast<int>(left));
+    if (written == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "writev");
+    }
+    size_t bytes = static_cast<size_t>(written);
+    for (; left != 0 && bytes >= part->iov_len; ++part, --left) {
+      bytes -= part->iov_len;
+    }
+    if (left != 0) {
+      part->iov_base = static_cast<char*>(part->iov_base) + bytes;
+      part->iov_len -= bytes;
+    }
+  }
+}
+
+inline void read_fully(int fd, void* data, size_t bytes) {
+  char* position = static_cast<char*>(data);
+  while (bytes != 0) {
+    ssize_t got = read(fd, position, bytes);
+    if (got == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), "read");
+    }
+    if (got == 0) {
+      throw std::runtime_error("list data ends early");
+    }
+    position += got;
+    bytes -= static_cast<size_t>(got);
+  }
+}
+
+// Elements this large are gathered straight from their nodes; smaller ones are first
+// packed into a staging chunk, as the kernel's per-iovec cost outweighs copying them
+inline constexpr size_t kGatheredElementSize = 512;
+inline constexpr size_t kStagingChunkSize = 1 << 20;
+
+// Writes `lst` with writev(), up to IOV_MAX pieces per call
+template <typename T, typename Alloc>
+  requires std::is_trivially_copyable_v<T>
+void write_binary(int fd, const list<T, Alloc>& lst) {
+  ListBinaryHeader header{ lst.size(), sizeof(T) };
+  std::vector<iovec> batch;
+  batch.reserve(IOV_MAX);
+  batch.push_back({ &header, sizeof(header) });
+
+  if constexpr (sizeof(T) >= kGatheredElementSize) {
+    for (const T& elem : lst) {
+      if (batch.size() == IOV_MAX) {
+        writev_fully(fd, batch);
+        batch.clear();
+      }
+      batch.push_back({ const_cast<T*>(std::addressof(elem)), sizeof(T) });
+    }
+    writev_fully(fd, batch);
+  } else {
+    constexpr size_t kChunkBytes = kStagingChunkSize / sizeof(T) * sizeof(T);
+    auto chunk = std::make_unique_for_overwrite<char[]>(kChunkBytes);
+    size_t used = 0;
+    for (const T& elem : lst) {
+      if (used == kChunkBytes) {
+        batch.push_back({ chunk.get(), used });
+        writev_fully(fd, batch);
+        batch.clear();
+        used = 0;
+      }
+      std::memcpy(chunk.get() + used, std::addressof(elem), sizeof(T));
+      used += sizeof(T);
+    }
+    batch.push_back({ chunk.get(), used });
+    writev_fully(fd, batch);
+  }
+}
+
+// Appends a list written by write_binary(). The payload is read with one call and its nodes
+// come from a single block where the allocator allows; on failure `lst` is left unchanged.
+template <typename T, typename Alloc>
+  requires std::is_trivially_copyable_v<T>
+void read_binary(int fd, list<T, Alloc>& lst) {
+  ListBinaryHeader header{};
+  read_fully(fd, &header, sizeof(header));
+  if (header.element_size != sizeof(T)) {
+    throw std::invalid_argument("list data holds elements of another size");
+  }
+
+  std::allocator<T> staging;
+  size_t count = header.count;
+  T* payload = staging.allocate(count);
+  try {
+    read_fully(fd, payload, count * sizeof(T));
+    lst.insert(lst.end(), payload, payload + count);
+  } catch(...) {
+    staging.deallocate(payload, count);
+    throw;
+  }
+  staging.deallocate(payload, count);
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Lock-free multi-producer single-consumer FIFO queue (Vyukov's algorithm). Nodes have
+// list's layout, two link words followed by the element: `next` is the queue link and
+// `prev` chains consumed nodes awaiting reclamation. Pushing costs one atomic exchange and
+// never waits for other threads; popping uses no read-modify-write at all.
+//
+// push()/emplace() may be called from any thread, so Alloc must be thread-safe, e.g.
+// ConcurrentStackAllocator. try_pop() and the destructor belong to the single consumer.
+// Consumed nodes are destroyed kReclaimBatch at a time and handed back to the producers
+// through a ring of kRecycleSlots entries, which they try before the allocator. Nodes
+// only return to the allocator with the queue, so its memory stays bounded by the most
+// elements ever queued at once, even on a bump arena like ConcurrentStackAllocator that
+// would not reuse them itself.
+template <typename T, typename Alloc = std::allocator<T>>
+class mpsc_queue {
+  struct BaseNode {
+    std::atomic<BaseNode*> next;
+    BaseNode* prev;
+
+    BaseNode(): next(nullptr), prev(nullptr) {}
+  };
+
+  struct Node : BaseNode {
+    T data;
+
+    template <typename... Args>
+    Node(Args&&... args): BaseNode(), data(std::forward<Args>(args)...) {}
+  };
+
+  using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  static constexpr size_t kCacheLine = 64;
+  static constexpr size_t kRecycleSlots = 1024;
+
+  node_allocator alloc_;
+  // Producers only write head_ and recycle_head_, the consumer only the members after them
+  alignas(kCacheLine) std::atomic<BaseNode*> head_;
+  std::atomic<uint64_t> recycle_head_ = 0; // next ring slot a producer takes
+  alignas(kCacheLine) BaseNode* tail_; // already consumed, tail_->next is the front
+  BaseNode stub_;
+  BaseNode* retired_ = nullptr;
+  size_t retired_count_ = 0;
+  BaseNode* spare_ = nullptr; // destroyed nodes the ring had no room for, chained by prev
+  std::atomic<uint64_t> recycle_tail_ = 0; // next ring slot the consumer fills
+  std::atomic<BaseNode*> recycled_[kRecycleSlots] = {};
+
+  void link(Node* node);
+  void retire(BaseNode* node);
+  void release_retired();
+  void release(BaseNode* node);
+  // Producer side: takes a recycled node, or returns nullptr when the ring is empty
+  Node* reuse();
+  // Consumer side: moves spare nodes into the ring while it has room
+  void recycle();
+
+public:
+  static constexpr size_t kReclaimBatch = 64;
+
+  explicit mpsc_queue(const Alloc& allocator = Alloc())
+      : alloc_(allocator), head_(&stub_), tail_(&stub_), stub_() {}
+
+  mpsc_queue(const mpsc_queue&) = delete;
+  mpsc_queue& operator=(const mpsc_queue&) = delete;
+
+  ~mpsc_queue();
+
+  void push(const T& value) { emplace(value); }
+  void push(T&& value) { emplace(std::move(value)); }
+  template <typename... Args>
+  void emplace(Args&&... args);
+
+  // Moves the front element to `value`. Returns false if the queue is empty, which it may
+  // also briefly appear while a push that began earlier is still linking its node.
+  bool try_pop(T& value);
+  bool empty() const { return tail_->next.load(std::memory_order_acquire) == nullptr; }
+};
+
+template <typename T, typename Alloc>
+template <typename... Args>
+void mpsc_queue<T, Alloc>::emplace(Args&&... args) {
+  Node* node = reuse();
+  if (node == nullptr) {
+    node = node_traits::allocate(alloc_, 1);
+  }
+  try {
+    node_traits::construct(alloc_, node, std::forward<Args>(args)...);
+  } catch(...) {
+    node_traits::deallocate(alloc_, node, 1);
+    throw;
+  }
+  link(node);
+}
+
+template <typename T, typename Alloc>
+auto mpsc_queue<T, Alloc>::reuse() -> Node* {
+  uint64_t head = recycle_head_.load(std::memory_order_relaxed);
+  while (head != recycle_tail_.load(std::memory_order_acquire)) {
+    // The consumer refills this slot only after recycle_head_ has moved past it, and
+    // then the compare-and-swap fails
+    BaseNode* node = recycled_[head % kRecycleSlots].load(std::memory_order_relaxed);
+    if (recycle_head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+      return static_cast<Node*>(static_cast<void*>(node));
+    }
+  }
+  return nullptr;
+}
+
+template <typename T, typename Alloc>
+void mpsc_queue<T, Alloc>::recycle() {
+  uint64_t tail = recycle_tail_.load(std::memory_order_relaxed);
+  uint64_t head = recycle_head_.load(std::memory_order_acquire);
+  while (spare_ != nullptr && tail - head < kRecycleSlots) {
+    BaseNode* prev = spare_->prev;
+    recycled_[tail % kRecycleSlots].store(spare_, std::memory_order_relaxed);
+    spare_ = prev;
+    ++tail;
+  }
+  recycle_tail_.store(tail, std::memory_order_release);
+}
+
+template <typename T, typename Alloc>
+void mpsc_queue<T, Alloc>::link(Node* node) {
+  // From the exchange until the store the node is unreachable, see try_pop()
+  BaseNode* prev = head_.exchange(node, std::memory_order_acq_rel);
+  prev->next.store(node, std::memory_order_release);
+}
+
+template <typename T, typename Alloc>
+bool mpsc_queue<T, Alloc>::try_pop(T& value) {
+  BaseNode* next = tail_->next.load(std::memory_order_acquire);
+  if (next == nullptr) {
+    return false;
+  }
+  // The front node stays in the queue as its new tail, only the previous tail goes
+  value = std::move(static_cast<Node*>(next)->data);
+  retire(tail_);
+  tail_ = next;
+  return true;
+}
+
+template <typename T, typename Alloc>
+void mpsc_queue<T, Alloc>::retire(BaseNode* node) {
+  if (node == &stub_) {
+    return;
+  }
+  node->prev = retired_;
+  retired_ = node;
+  if (++retired_count_ == kReclaimBatch) {
+    release_retired();
+  }
+}
+
+template <typename T, typename Alloc>
+void mpsc_queue<T, Alloc>::release_retired() {
+  while (retired_ != nullptr) {
+    BaseNode* prev = retired_->prev;
+    node_traits::destroy(alloc_, static_cast<Node*>(retired_));
+    // Only the links outlive the element, to chain the memory until a producer takes it
+    BaseNode* spare = ::new (static_cast<void*>(retired_)) BaseNode();
+    spare->prev = spare_;
+    spare_ = spare;
+    retired_ = prev;
+  }
+  retired_count_ = 0;
+  recycle();
+}
+
+template <typename T, typename Alloc>
+void mpsc_queue<T, Alloc>::release(BaseNode* node) {
+  Node* old_node = static_cast<Node*>(node);
+  node_traits::destroy(alloc_, old_node);
+  node_traits::deallocate(alloc_, old_node, 1);
+}
+
+template <typename T, typename Alloc>
+mpsc_queue<T, Alloc>::~mpsc_queue() {
+  release_retired();
+  uint64_t tail = recycle_tail_.load(std::memory_order_relaxed);
+  for (uint64_t slot = recycle_head_.load(std::memory_order_acquire); slot != tail; ++slot) {
+    BaseNode* node = recycled_[slot % kRecycleSlots].load(std::memory_order_relaxed);
+    node_traits::deallocate(alloc_, static_cast<Node*>(static_cast<void*>(node)), 1);
+  }
+  while (spare_ != nullptr) {
+    BaseNode* prev = spare_->prev;
+    node_traits::deallocate(alloc_, static_cast<Node*>(static_cast<void*>(spare_)), 1);
+    spare_ = prev;
+  }
+  BaseNode* node = tail_;
+  while (node != nullptr) {
+    BaseNode* next = node->next.load(std::memory_order_acquire);
+    if (node != &stub_) {
+      release(node);
+    }
+    node = next;
+  }
+}
@@ -1,20 +1,36 @@
 #include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
 #include <stdexcept>
 #include <string>
 #include <list>
+#include <unordered_map>
 #include <vector>
 #include <deque>
 #include <memory>
 #include <iostream>
 #include <fstream>
 #include <algorithm>
+#include <numeric>
 #include <type_traits>
 #include <sstream>
+#include <random>
+#include <thread>
+#include <mutex>
 #include <cassert>
+#include <fcntl.h>
 #include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "stackallocator.h"
 #include "list.h"
+#include "unrolled_list.h"
+#include "compact_list.h"
+#include "list_io.h"
+#include "indexed_list.h"
+#include "mpsc_queue.h"
 
 // template<typename T, typename Alloc = std::allocator<T>>
 //using list = std::list<T, Alloc>;
@@ -25,6 +41,12 @@
 constexpr size_t STORAGE_SIZE = 150'000'000;
 StackStorage<STORAGE_SIZE> STATIC_STORAGE;
 
+// Largest thread count of the scaling benchmarks: their work per thread is fixed, and
+// STATIC_STORAGE has room for 16 threads' worth
+unsigned MaxBenchmarkThreads() {
+    return std::clamp(std::thread::hardware_concurrency(), 4u, 16u);
+}
+
 template <typename Alloc = std::allocator<int>>
 void BasicListTest(Alloc alloc = Alloc()) {
     list<int, Alloc> lst(alloc);
@@ -318,6 +340,726 @@ void TestAlignment() {
     ldalloc.deallocate(pld, 25);
 }
 
+void TestMemoryReuse() {
+    StackStorage<200'000> storage;
+    StackAllocator<int, 200'000> alloc(storage);
+
+    list<int, StackAllocator<int, 200'000>> lst(alloc);
+    for (int i = 0; i < 1'000; ++i) {
+        lst.push_back(i);
+    }
+    size_t used = storage.used();
+
+    // Without recycling this would need far more than 200'000 bytes
+    for (int i = 0; i < 1'000'000; ++i) {
+        lst.push_back(i);
+        lst.pop_front();
+    }
+    assert(lst.size() == 1'000);
+    assert(*lst.begin() == 999'000);
+    assert(storage.used() <= used + 64);
+
+    StackAllocator<char, 200'000> charalloc(alloc);
+    char* first = charalloc.allocate(40);
+    char* second = charalloc.allocate(40);
+    charalloc.deallocate(first, 40);
+    assert(charalloc.allocate(40) == first);
+    charalloc.deallocate(second, 40);
+    assert(charalloc.allocate(40) == second);
+}
+
+void TestScopedRegion() {
+    StackStorage<200'000> storage;
+    StackAllocator<int, 200'000> alloc(storage);
+
+    list<int, StackAllocator<int, 200'000>> outer(alloc);
+    outer.push_back(1);
+    size_t used = storage.used();
+
+    auto marker = storage.mark();
+    for (int i = 0; i < 100; ++i) {
+        outer.push_back(i);
+    }
+    // Everything above the marker is released before the rewind; popping afterwards would
+    // hand blocks above the new top to the free lists
+    for (int i = 0; i < 100; ++i) {
+        outer.pop_back();
+    }
+    storage.rewind(marker);
+    assert(storage.used() == used);
+
+    {
+        StackRegion region(storage);
+        list<int, StackAllocator<int, 200'000>> temp(alloc);
+        for (int i = 0; i < 1'000; ++i) {
+            temp.push_back(i);
+        }
+        assert(storage.in_scoped_region());
+        assert(storage.used() > used);
+    }
+    assert(!storage.in_scoped_region());
+    assert(storage.used() == used);
+    assert(outer.size() == 1 && *outer.begin() == 1);
+
+    // Spare nodes cached inside a region are not reused after it has rewound
+    using Alloc = StackAllocator<int, 200'000>;
+    {
+        StackRegion region(storage);
+        for (int i = 0; i < 10; ++i) {
+            outer.push_back(i);
+        }
+        for (int i = 0; i < 10; ++i) {
+            outer.pop_back();
+        }
+        assert(outer.capacity() == 11);
+    }
+    assert(outer.capacity() == 1);
+    {
+        list<int, Alloc> later(alloc);
+        for (int i = 0; i < 10; ++i) {
+            later.push_back(-1);
+        }
+        for (int i = 0; i < 10; ++i) {
+            outer.push_back(i);
+        }
+        assert(std::count(later.begin(), later.end(), -1) == 10);
+        for (int i = 0; i < 10; ++i) {
+            outer.pop_back();
+        }
+    }
+
+    // Lists older than the innermost region still give their nodes back for reuse
+    auto older = std::make_unique<list<int, Alloc>>(1'000, 0, alloc);
+    {
+        StackRegion region(storage);
+        auto inner = std::make_unique<list<int, Alloc>>(1'000, 0, alloc);
+        {
+            StackRegion nested(storage);
+            size_t region_start = storage.used();
+            older.reset();
+            inner.reset();
+            list<int, Alloc> temp(alloc);
+            for (int i = 0; i < 2'000; ++i) {
+                temp.push_back(i);
+            }
+            assert(storage.used() <= region_start);
+        }
+    }
+
+    // Blocks released below a region stay on the free lists after it rewinds
+    {
+        list<int, Alloc> low(alloc);
+        list<int, Alloc> pinned(alloc);
+        for (int i = 0; i < 100; ++i) {
+            low.push_back(i);
+        }
+        pinned.push_back(0);
+        low.clear();
+        low.shrink_to_fit();
+        size_t before = storage.used();
+        {
+            StackRegion region(storage);
+            alloc.allocate(1'000);
+        }
+        for (int i = 0; i < 100; ++i) {
+            low.push_back(i);
+        }
+        assert(storage.used() == before);
+    }
+}
+
+void TestOverflow() {
+    StackStorage<1'000> storage;
+    StackAllocator<int, 1'000> alloc(storage);
+
+    bool thrown = false;
+    try {
+        list<int, StackAllocator<int, 1'000>> lst(1'000, 0, alloc);
+    } catch (std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    storage.enable_overflow(4'096);
+    list<int, StackAllocator<int, 1'000>> lst(alloc);
+    for (int i = 0; i < 100'000; ++i) {
+        lst.push_back(i);
+    }
+    assert(storage.overflow_capacity() >= 100'000 * sizeof(int));
+    long long sum = 0;
+    for (int x : lst) {
+        sum += x;
+    }
+    assert(sum == 100'000ll * 99'999 / 2);
+
+    size_t overflow = storage.overflow_capacity();
+    {
+        StackRegion region(storage);
+        StackAllocator<char, 1'000> charalloc(alloc);
+        charalloc.allocate(overflow * 4);
+        assert(storage.overflow_capacity() > overflow);
+    }
+    assert(storage.overflow_capacity() == overflow);
+
+    // Regions that overflow once each keep asking for chunks of the same size
+    for (int i = 0; i < 1'000; ++i) {
+        StackRegion region(storage);
+        StackAllocator<char, 1'000> charalloc(alloc);
+        charalloc.allocate(overflow);
+        assert(storage.overflow_capacity() <= overflow * 4);
+    }
+    assert(storage.overflow_capacity() == overflow);
+}
+
+void TestMemoryResource() {
+    StackStorage<200'000> storage;
+    StackMemoryResource resource(storage);
+
+    {
+        std::pmr::list<int> std_list(&resource);
+        std::pmr::unordered_map<int, std::pmr::string> map(&resource);
+        list<int, std::pmr::polymorphic_allocator<int>> lst(&resource);
+
+        for (int i = 0; i < 100; ++i) {
+            std_list.push_back(i);
+            map.emplace(i, std::pmr::string(50, 'a' + i % 26));
+            lst.push_back(i);
+        }
+        assert(map.at(27) == std::pmr::string(50, 'b'));
+        assert(*std::next(lst.begin(), 42) == 42);
+        assert(resource.statistics().upstream_allocations == 0);
+        assert(storage.used() > 100 * 50);
+    }
+    assert(resource.statistics().bytes_in_use == 0);
+    assert(resource.statistics().allocations == resource.statistics().deallocations);
+
+    // Overflow goes to the upstream resource and is returned there
+    StackStorage<1'000> small_storage;
+    StackMemoryResource fallback(small_storage, std::pmr::new_delete_resource());
+    {
+        list<int, std::pmr::polymorphic_allocator<int>> lst(&fallback);
+        for (int i = 0; i < 1'000; ++i) {
+            lst.push_back(i);
+        }
+        assert(fallback.statistics().upstream_allocations > 0);
+    }
+    assert(fallback.statistics().upstream_bytes_in_use == 0);
+
+    StackMemoryResource strict(small_storage);
+    bool thrown = false;
+    try {
+        std::ignore = strict.allocate(10'000);
+    } catch (std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+#ifdef STACK_ALLOCATOR_STATS
+void TestStatistics() {
+    StackStorage<200'000> storage;
+    StackAllocator<char, 200'000> charalloc(storage);
+    StackAllocator<long double, 200'000> ldalloc(storage);
+
+    char* pchar = charalloc.allocate(3);
+    long double* pld = ldalloc.allocate(2);
+    const auto& stats = storage.statistics();
+
+    assert(stats.allocations == 2);
+    assert(stats.bytes_in_use == 8 + 2 * sizeof(long double));
+    assert(stats.alignment_waste == (alignof(long double) > 8 ? alignof(long double) - 8 : 0));
+    assert(stats.footprint == storage.used());
+    assert(stats.size_histogram[3] == 1);
+
+    charalloc.deallocate(pchar, 3);
+    ldalloc.deallocate(pld, 2);
+    assert(stats.bytes_in_use == 0);
+    // Popping the long doubles gave their alignment padding back too
+    assert(storage.used() == 8);
+    assert(stats.footprint == storage.used());
+    assert(stats.high_water_mark == storage.used() + 2 * sizeof(long double) + stats.alignment_waste);
+
+    pchar = charalloc.allocate(3);
+    assert(stats.free_list_hits == 1);
+    charalloc.deallocate(pchar, 3);
+
+    StackMemoryResource resource(storage);
+    std::pmr::polymorphic_allocator<char> pmr_alloc(&resource);
+    bool thrown = false;
+    try {
+        std::ignore = pmr_alloc.allocate(300'000);
+    } catch (std::bad_alloc&) {
+        thrown = true;
+    }
+    assert(thrown);
+    assert(charalloc.statistics().failed_allocations == 1);
+}
+#endif
+
+void TestMappedStorage() {
+    for (bool huge_pages : {false, true}) {
+        MappedStackStorage storage(64 << 20, {.huge_pages = huge_pages, .prefault = !huge_pages});
+        StackAllocator<int, 0> alloc(storage);
+
+        assert(storage.capacity() == 64 << 20);
+        {
+            list<int, StackAllocator<int, 0>> lst(alloc);
+            for (int i = 0; i < 1'000'000; ++i) {
+                lst.push_back(i);
+            }
+            assert(*lst.rbegin() == 999'999);
+        }
+
+        storage.reset();
+        assert(storage.used() == 0);
+
+        list<int, StackAllocator<int, 0>> lst(100, 7, alloc);
+        assert(*lst.begin() == 7);
+    }
+}
+
+struct MoveOnly {
+    std::unique_ptr<int> value;
+    explicit MoveOnly(int x): value(std::make_unique<int>(x)) {}
+};
+
+void TestMoveSemantics() {
+    list<std::string> lst;
+    std::string heavy(1'000, 'x');
+    lst.push_back(std::move(heavy));
+    assert(heavy.empty());
+    lst.emplace_back(3, 'y');
+    lst.emplace_front("front");
+    lst.insert(std::next(lst.cbegin()), std::string("middle"));
+
+    const std::string* data = &*std::next(lst.begin());
+    list<std::string> moved = std::move(lst);
+    assert(lst.size() == 0 && lst.begin() == lst.end());
+    assert(moved.size() == 4);
+    assert(&*std::next(moved.begin()) == data);
+
+    std::string s;
+    for (const auto& x : moved) {
+        s += x.substr(0, 6) + " ";
+    }
+    assert(s == "front middle xxxxxx yyy ");
+
+    lst.push_back("reused");
+    lst = std::move(moved);
+    assert(lst.size() == 4 && *lst.begin() == "front");
+
+    list<std::string> copy;
+    copy = lst;
+    assert(*copy.rbegin() == "yyy" && *lst.rbegin() == "yyy");
+
+    list<MoveOnly> move_only;
+    move_only.emplace_back(1);
+    move_only.push_back(MoveOnly(2));
+    move_only.emplace_front(0);
+    int expected = 0;
+    for (const auto& x : move_only) {
+        assert(*x.value == expected++);
+    }
+
+    // Unequal allocators: elements are moved one by one
+    StackStorage<200'000> first_storage;
+    StackStorage<200'000> second_storage;
+    using Alloc = StackAllocator<std::string, 200'000>;
+    list<std::string, Alloc> first(Alloc{first_storage});
+    list<std::string, Alloc> second(Alloc{second_storage});
+    first.push_back(std::string(100, 'a'));
+    second = std::move(first);
+    assert(second.size() == 1 && second.begin()->size() == 100);
+    assert(second.get_allocator() == Alloc{second_storage});
+
+    list<std::string, Alloc> third(std::move(second), Alloc{first_storage});
+    assert(third.size() == 1 && *third.begin() == std::string(100, 'a'));
+
+    list<std::string, Alloc> fourth(Alloc{first_storage});
+    fourth.push_back("b");
+    fourth.swap(third);
+    assert(fourth.size() == 1 && *fourth.begin() == std::string(100, 'a'));
+    assert(third.size() == 1 && *third.begin() == "b");
+}
+
+// Counts elements allocated through any rebind of CountingAllocator
+struct AllocationCounter {
+    static size_t allocations;
+    static size_t deallocations;
+};
+
+size_t AllocationCounter::allocations = 0;
+size_t AllocationCounter::deallocations = 0;
+
+template <typename T>
+struct CountingAllocator : public std::allocator<T>, public AllocationCounter {
+
+    template <typename U>
+    struct rebind {
+        using other = CountingAllocator<U>;
+    };
+
+    CountingAllocator() = default;
+
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        allocations += n;
+        return std::allocator<T>::allocate(n);
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        deallocations += n;
+        std::allocator<T>::deallocate(pointer, n);
+    }
+};
+
+void TestNodeCache() {
+    size_t& allocations = AllocationCounter::allocations;
+    size_t& deallocations = AllocationCounter::deallocations;
+    
+    {
+        list<int, CountingAllocator<int>> lst;
+        lst.reserve(100);
+        assert(lst.capacity() == 100);
+        assert(allocations == 100);
+
+        size_t before = allocations;
+        for (int round = 0; round < 10; ++round) {
+            for (int i = 0; i < 100; ++i) {
+                lst.push_back(i);
+            }
+            for (int i = 0; i < 50; ++i) {
+                lst.pop_front();
+                lst.pop_back();
+            }
+        }
+        assert(allocations == before);
+        assert(deallocations == 0);
+
+        lst.insert(lst.cend(), 1);
+        list<int, CountingAllocator<int>> other(100, 2);
+        before = allocations;
+        other = lst;
+        assert(other.size() == 1 && *other.begin() == 1);
+        other = list<int, CountingAllocator<int>>(60, 3);
+        assert(other.size() == 60 && *other.rbegin() == 3);
+        assert(allocations == before + 60);
+
+        lst.shrink_to_fit();
+        assert(lst.capacity() == 1);
+        assert(deallocations == 99);
+    }
+    assert(allocations == deallocations);
+}
+
+
+void TestBatchInsertion() {
+    {
+        StackStorage<100'000> storage;
+        StackAllocator<int, 100'000> alloc(storage);
+
+        // All nodes come from one block and are linked in address order
+        list<int, StackAllocator<int, 100'000>> lst(1000, 7, alloc);
+        auto it = lst.begin();
+        const char* previous = reinterpret_cast<const char*>(&*it);
+        std::ptrdiff_t stride = reinterpret_cast<const char*>(&*++it) - previous;
+        assert(stride > 0);
+        for (; it != lst.end(); ++it) {
+            assert(reinterpret_cast<const char*>(&*it) - previous == stride);
+            previous = reinterpret_cast<const char*>(&*it);
+        }
+        assert(storage.used() == 1000 * static_cast<size_t>(stride));
+
+        auto copy = lst;
+        assert(copy.size() == 1000 && *copy.rbegin() == 7);
+    }
+
+    list<int> lst = {1, 5};
+    std::vector<int> middle = {2, 3, 4};
+    auto first = lst.insert(std::next(lst.cbegin()), middle.begin(), middle.end());
+    assert(*first == 2);
+    assert(std::equal(lst.begin(), lst.end(), std::vector<int>{1, 2, 3, 4, 5}.begin()));
+
+    std::istringstream input("6 7 8");
+    lst.insert(lst.cend(), std::istream_iterator<int>(input), std::istream_iterator<int>());
+    lst.append_range(std::vector<int>{9, 10});
+    lst.prepend_range(std::views::iota(-1, 1));
+    assert(lst.size() == 12);
+    assert(*lst.begin() == -1 && *lst.rbegin() == 10);
+
+    lst.insert(lst.cbegin(), 3, 42);
+    assert(lst.size() == 15 && *lst.begin() == 42);
+
+    lst.assign(2, 1);
+    assert(lst.size() == 2 && *lst.begin() == 1 && *lst.rbegin() == 1);
+    lst.assign({4, 3, 2, 1});
+    assert(std::equal(lst.begin(), lst.end(), std::vector<int>{4, 3, 2, 1}.begin()));
+
+    list<int> from_range(middle.begin(), middle.end());
+    assert(from_range.size() == 3 && *from_range.rbegin() == 4);
+
+    // A throwing element leaves the list as it was
+    Accountant::reset();
+    ThrowingAccountant::need_throw = false;
+    {
+        list<ThrowingAccountant> accountants;
+        accountants.push_back(0);
+        accountants.push_back(1);
+
+        std::vector<int> values(10, 3);
+        ThrowingAccountant::need_throw = true;
+        try {
+            accountants.insert(std::next(accountants.cbegin()), values.begin(), values.end());
+            assert(false);
+        } catch (...) {
+        }
+        ThrowingAccountant::need_throw = false;
+
+        assert(accountants.size() == 2);
+        assert(accountants.begin()->value == 0 && accountants.rbegin()->value == 1);
+    }
+    assert(Accountant::ctor_calls == Accountant::dtor_calls);
+}
+
+void TestClear() {
+    Accountant::reset();
+    {
+        list<Accountant> lst(10);
+        lst.clear();
+        assert(lst.size() == 0 && lst.begin() == lst.end());
+        assert(Accountant::ctor_calls == 10 && Accountant::dtor_calls == 10);
+
+        lst.emplace_back();
+        assert(lst.size() == 1);
+    }
+    assert(Accountant::ctor_calls == Accountant::dtor_calls);
+
+    {
+        size_t before = AllocationCounter::allocations;
+        list<int, CountingAllocator<int>> lst(100, 1);
+        lst.clear();
+        assert(lst.capacity() == 100);
+        lst.assign(100, 2);
+        assert(AllocationCounter::allocations == before + 100);
+    }
+    assert(AllocationCounter::allocations == AllocationCounter::deallocations);
+
+    // Teardown hands the nodes back as one chain, the stack is popped all the way down
+    StackStorage<200'000> storage;
+    StackAllocator<int, 200'000> alloc(storage);
+    {
+        list<int, StackAllocator<int, 200'000>> lst(alloc);
+        for (int i = 0; i < 1'000; ++i) {
+            lst.push_back(i);
+        }
+        lst.pop_front();
+        assert(storage.used() > 0);
+    }
+    assert(storage.used() == 0);
+
+    // Below the top the chain joins the free list whole, and the next list reuses all of it
+    {
+        list<int, StackAllocator<int, 200'000>> upper(alloc);
+        {
+            list<int, StackAllocator<int, 200'000>> lower(alloc);
+            for (int i = 0; i < 1'000; ++i) {
+                lower.push_back(i);
+            }
+            upper.push_back(0);
+        }
+        size_t used = storage.used();
+        list<int, StackAllocator<int, 200'000>> again(alloc);
+        for (int i = 0; i < 1'000; ++i) {
+            again.push_back(i);
+        }
+        assert(storage.used() == used);
+    }
+}
+
+void TestSort() {
+    using namespace std::chrono;
+
+    std::mt19937 gen(42);
+    std::vector<std::pair<int, int>> values;
+    for (int i = 0; i < 10'000; ++i) {
+        values.emplace_back(gen() % 100, i);
+    }
+
+    // Equal keys keep their original order
+    auto by_key = [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; };
+    list<std::pair<int, int>> pairs(values.begin(), values.end());
+    std::vector<std::pair<int, int>> expected = values;
+    pairs.sort(by_key);
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    assert(pairs.size() == expected.size());
+    assert(std::equal(pairs.begin(), pairs.end(), expected.begin()));
+    assert(std::equal(pairs.rbegin(), pairs.rend(), expected.rbegin()));
+
+    list<int> lst = {5, 1, 4, 1, 3};
+    lst.sort(std::greater<>());
+    assert(std::equal(lst.begin(), lst.end(), std::vector<int>{5, 4, 3, 1, 1}.begin()));
+
+    list<int> first = {1, 3, 5, 7};
+    list<int> second = {0, 3, 8, 9};
+    first.merge(second);
+    assert(second.size() == 0 && first.size() == 8);
+    assert(std::equal(first.begin(), first.end(), std::vector<int>{0, 1, 3, 3, 5, 7, 8, 9}.begin()));
+    first.merge(list<int>{4, 10});
+    assert(first.size() == 10 && *first.rbegin() == 10);
+
+    list<int> repeated = {1, 1, 2, 2, 2, 1, 3, 3};
+    assert(repeated.unique() == 4);
+    assert(std::equal(repeated.begin(), repeated.end(), std::vector<int>{1, 2, 1, 3}.begin()));
+    assert(repeated.remove(*repeated.begin()) == 2);
+    assert(repeated.remove_if([](int x) { return x > 2; }) == 1);
+    assert(repeated.size() == 1 && *repeated.begin() == 2);
+
+    // A throwing comparator leaves a valid list with the same elements
+    list<int> shuffled;
+    for (int i = 0; i < 1'000; ++i) {
+        shuffled.push_back(gen() % 1'000);
+    }
+    int comparisons = 0;
+    try {
+        shuffled.sort([&comparisons](int lhs, int rhs) {
+            if (++comparisons == 5'000) {
+                throw std::runtime_error("comparison failed");
+            }
+            return lhs < rhs;
+        });
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    assert(shuffled.size() == 1'000);
+    assert(std::distance(shuffled.begin(), shuffled.end()) == 1'000);
+    assert(std::distance(shuffled.rbegin(), shuffled.rend()) == 1'000);
+    shuffled.sort();
+    assert(std::is_sorted(shuffled.begin(), shuffled.end()));
+
+    // Sanitized builds are slow, so the comparison uses a smaller list than production ones
+    constexpr int kElements = 1'000'000;
+    std::list<int> std_list;
+    list<int> our_list;
+    for (int i = 0; i < kElements; ++i) {
+        int value = static_cast<int>(gen());
+        std_list.push_back(value);
+        our_list.push_back(value);
+    }
+
+    auto start = high_resolution_clock::now();
+    std_list.sort();
+    auto middle = high_resolution_clock::now();
+    our_list.sort();
+    auto finish = high_resolution_clock::now();
+
+    assert(std::equal(our_list.begin(), our_list.end(), std_list.begin()));
+    std::cerr << " Sorting " << kElements << " elements: std::list::sort "
+              << duration_cast<milliseconds>(middle - start).count() << " ms, list::sort "
+              << duration_cast<milliseconds>(finish - middle).count() << " ms" << std::endl;
+}
+
+void TestParallelSort() {
+    using namespace std::chrono;
+
+    std::mt19937 gen(7);
+    std::vector<std::pair<int, int>> values;
+    for (int i = 0; i < 100'000; ++i) {
+        values.emplace_back(gen() % 1'000, i);
+    }
+    auto by_key = [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; };
+    std::vector<std::pair<int, int>> expected = values;
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+
+    // Uneven thread counts leave a chain without a partner in some merge rounds
+    for (size_t threads : {2, 3, 4, 7}) {
+        list<std::pair<int, int>> pairs(values.begin(), values.end());
+        pairs.sort(parallel_sort_policy{threads}, by_key);
+        assert(pairs.size() == expected.size());
+        assert(std::equal(pairs.begin(), pairs.end(), expected.begin()));
+        assert(std::equal(pairs.rbegin(), pairs.rend(), expected.rbegin()));
+    }
+
+    list<int> small = {3, 1, 2};
+    small.sort(parallel_sort);
+    assert(std::equal(small.begin(), small.end(), std::vector<int>{1, 2, 3}.begin()));
+
+    // A comparator throwing on a worker thread is rethrown, the list stays whole
+    list<int> numbers;
+    for (int i = 0; i < 50'000; ++i) {
+        numbers.push_back(gen() % 1'000);
+    }
+    std::atomic<int> comparisons = 0;
+    try {
+        numbers.sort(parallel_sort_policy{4}, [&comparisons](int lhs, int rhs) {
+            if (++comparisons == 100'000) {
+                throw std::runtime_error("comparison failed");
+            }
+            return lhs < rhs;
+        });
+        assert(false);
+    } catch (const std::runtime_error&) {
+    }
+    assert(numbers.size() == 50'000);
+    assert(std::distance(numbers.begin(), numbers.end()) == 50'000);
+    assert(std::distance(numbers.rbegin(), numbers.rend()) == 50'000);
+
+    constexpr int kElements = 1'000'000;
+    list<int> sequential;
+    for (int i = 0; i < kElements; ++i) {
+        sequential.push_back(static_cast<int>(gen()));
+    }
+    list<int> parallel = sequential;
+
+    auto start = high_resolution_clock::now();
+    sequential.sort();
+    auto middle = high_resolution_clock::now();
+    parallel.sort(parallel_sort);
+    auto finish = high_resolution_clock::now();
+
+    assert(std::equal(parallel.begin(), parallel.end(), sequential.begin()));
+    std::cerr << " Sorting " << kElements << " elements: sort() "
+              << duration_cast<milliseconds>(middle - start).count() << " ms, sort(parallel_sort) "
+              << duration_cast<milliseconds>(finish - middle).count() << " ms, hardware threads: "
+              << std::thread::hardware_concurrency() << std::endl;
+}
+
+void TestSplice() {
+    list<int> first = {1, 2, 3};
+    list<int> second = {10, 20, 30, 40};
+
+    // Nodes change lists, elements stay where they are
+    const int* twenty = &*std::next(second.begin());
+    first.splice(first.cend(), second, std::next(second.cbegin()));
+    assert(first.size() == 4 && second.size() == 3);
+    assert(&*first.rbegin() == twenty);
+
+    first.splice(first.cbegin(), second, std::next(second.cbegin()), second.cend(), 2);
+    assert(std::equal(first.begin(), first.end(), std::vector<int>{30, 40, 1, 2, 3, 20}.begin()));
+    assert(second.size() == 1 && *second.begin() == 10);
+
+    first.splice(std::next(first.cbegin()), second);
+    assert(first.size() == 7 && second.size() == 0 && second.begin() == second.end());
+    assert(std::equal(first.begin(), first.end(), std::vector<int>{30, 10, 40, 1, 2, 3, 20}.begin()));
+
+    // Moving nodes inside one list
+    first.splice(first.cbegin(), first, std::next(first.cbegin(), 3), first.cend());
+    assert(std::equal(first.begin(), first.end(), std::vector<int>{1, 2, 3, 20, 30, 10, 40}.begin()));
+    assert(std::equal(first.rbegin(), first.rend(), std::vector<int>{40, 10, 30, 20, 3, 2, 1}.begin()));
+    first.splice(first.cbegin(), first, first.cbegin());
+    first.splice(first.cend(), list<int>{50, 60});
+    assert(first.size() == 9 && *first.begin() == 1 && *first.rbegin() == 60);
+
+    // Unequal allocators fall back to moving elements
+    StackStorage<10'000> storage_a;
+    StackStorage<10'000> storage_b;
+    list<int, StackAllocator<int, 10'000>> a({1, 2, 3}, StackAllocator<int, 10'000>(storage_a));
+    list<int, StackAllocator<int, 10'000>> b({4, 5}, StackAllocator<int, 10'000>(storage_b));
+    a.splice(a.cend(), b);
+    assert(a.size() == 5 && b.size() == 0);
+    assert(std::equal(a.begin(), a.end(), std::vector<int>{1, 2, 3, 4, 5}.begin()));
+}
 
 template <typename T, bool PropagateOnConstruct, bool PropagateOnAssign>
 struct WhimsicalAllocator : public std::allocator<T> {
@@ -463,6 +1205,1027 @@ int ListPerformanceTest(List&& l) {
     return duration_cast<milliseconds>(finish - start).count();
 }
 
+// The same workload and checksum as ListPerformanceTest, for containers whose insert and erase
+// invalidate iterators: positions are taken from the returned iterators instead
+template <class List>
+int ReturnedIteratorsPerformanceTest(List&& l) {
+    using namespace std::chrono;
+
+    std::ostringstream oss;
+
+    auto start = high_resolution_clock::now();
+
+    for (int i = 0; i < 1'000'000; ++i) {
+        l.push_back(i);
+    }
+    for (int i = 0; i < 1'000'000; ++i) {
+        l.push_front(i);
+    }
+    auto it = std::next(l.begin(), 1'000'000);
+    oss << *it;
+
+    for (int i = 0; i < 2'000'000; ++i) {
+        it = std::next(l.insert(it, i));
+        if (i % 534'555 == 0) {
+            oss << *it;
+        }
+    }
+    oss << *it;
+
+    for (int i = 0; i < 1'500'000; ++i) {
+        l.pop_back();
+        if (i % 342'985 == 0) oss << *l.rbegin();
+    }
+    oss << *l.rbegin();
+
+    auto it2 = std::next(l.begin(), 999'999);
+    for (int i = 0; i < 1'000'000; ++i) {
+        it2 = l.erase(it2);
+        if (i % 432'098 == 0) oss << *it2;
+    }
+    oss << *it2;
+
+    for (int i = 0; i < 1'000'000; ++i) {
+        l.pop_front();
+    }
+    oss << *l.begin();
+
+    for (int i = 0; i < 1'000'000; ++i) {
+        l.push_back(i);
+    }
+    oss << *l.rbegin();
+
+    assert(oss.str() == "00000099999865701331402819710431628058149999904320988641969999991000000999999");
+
+    auto finish = high_resolution_clock::now();
+    return duration_cast<milliseconds>(finish - start).count();
+}
+
+void TestUnrolledList() {
+    using namespace std::chrono;
+
+    // Random edits checked against std::list, with a small K to split and merge a lot
+    std::mt19937 gen(11);
+    unrolled_list<int, std::allocator<int>, 4> unrolled;
+    std::list<int> reference;
+    for (int step = 0; step < 20'000; ++step) {
+        size_t index = reference.empty() ? 0 : gen() % (reference.size() + 1);
+        if (gen() % 3 != 0 || reference.empty()) {
+            auto it = unrolled.insert(std::next(unrolled.cbegin(), index), step);
+            assert(*it == step);
+            reference.insert(std::next(reference.begin(), index), step);
+        } else {
+            index = std::min(index, reference.size() - 1);
+            auto it = unrolled.erase(std::next(unrolled.cbegin(), index));
+            auto expected = reference.erase(std::next(reference.begin(), index));
+            assert((it == unrolled.end()) == (expected == reference.end()));
+            assert(it == unrolled.end() || *it == *expected);
+        }
+    }
+    assert(unrolled.size() == reference.size());
+    assert(std::equal(unrolled.begin(), unrolled.end(), reference.begin()));
+    assert(std::equal(unrolled.rbegin(), unrolled.rend(), reference.rbegin()));
+
+    unrolled_list<std::string> strings = {"a", "b"};
+    strings.push_front("front");
+    strings.emplace_back(3, 'c');
+    strings.insert(std::next(strings.cbegin()), *strings.begin());
+    auto copy = strings;
+    strings.pop_front();
+    assert(copy.size() == 5 && *copy.rbegin() == "ccc");
+    assert(*copy.begin() == "front" && *std::next(copy.begin()) == "front");
+    unrolled_list<std::string> moved = std::move(copy);
+    assert(moved.size() == 5 && copy.empty());
+    moved.swap(strings);
+    assert(strings.size() == 5 && moved.size() == 4);
+
+    // Bytes per element, measured in the arena that holds the nodes
+    size_t list_bytes = 0;
+    size_t unrolled_bytes = 0;
+    {
+        StackStorage<10'000'000> storage;
+        StackAllocator<int, 10'000'000> alloc(storage);
+        list<int, StackAllocator<int, 10'000'000>> lst(alloc);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        list_bytes = storage.used();
+    }
+    {
+        StackStorage<10'000'000> storage;
+        StackAllocator<int, 10'000'000> alloc(storage);
+        unrolled_list<int, StackAllocator<int, 10'000'000>> lst(alloc);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        unrolled_bytes = storage.used();
+    }
+    assert(unrolled_bytes * 3 < list_bytes);
+
+    int list_time = ReturnedIteratorsPerformanceTest(list<int>());
+    int unrolled_time = ReturnedIteratorsPerformanceTest(unrolled_list<int>());
+
+    list<int> lst;
+    unrolled_list<int> unrolled_ints;
+    for (int i = 0; i < 4'000'000; ++i) {
+        lst.push_back(i);
+        unrolled_ints.push_back(i);
+    }
+    auto start = high_resolution_clock::now();
+    long long list_sum = std::accumulate(lst.begin(), lst.end(), 0LL);
+    auto middle = high_resolution_clock::now();
+    long long unrolled_sum = std::accumulate(unrolled_ints.begin(), unrolled_ints.end(), 0LL);
+    auto finish = high_resolution_clock::now();
+    assert(list_sum == unrolled_sum);
+
+    std::cerr << " Bytes per int: list " << list_bytes / 100'000.0 << ", unrolled_list "
+              << unrolled_bytes / 100'000.0 << "; workload: list " << list_time
+              << " ms, unrolled_list " << unrolled_time << " ms; traversal of 4M: list "
+              << duration_cast<milliseconds>(middle - start).count() << " ms, unrolled_list "
+              << duration_cast<milliseconds>(finish - middle).count() << " ms" << std::endl;
+}
+
+void TestCompactList() {
+    std::mt19937 gen(5);
+    compact_list<int> compact;
+    std::list<int> reference;
+    auto pinned = compact.insert(compact.cend(), -1);
+    reference.push_back(-1);
+    for (int step = 0; step < 20'000; ++step) {
+        size_t index = gen() % (reference.size() + 1);
+        if (gen() % 3 != 0 || reference.size() == 1) {
+            compact.insert(std::next(compact.cbegin(), index), step);
+            reference.insert(std::next(reference.begin(), index), step);
+        } else {
+            index = std::min(index, reference.size() - 1);
+            if (*std::next(reference.begin(), index) == -1) {
+                continue;
+            }
+            compact.erase(std::next(compact.cbegin(), index));
+            reference.erase(std::next(reference.begin(), index));
+        }
+    }
+    // Iterators survive the array being reallocated many times over
+    assert(*pinned == -1);
+    assert(compact.size() == reference.size());
+    assert(std::equal(compact.begin(), compact.end(), reference.begin()));
+    assert(std::equal(compact.rbegin(), compact.rend(), reference.rbegin()));
+
+    compact_list<std::string> strings = {"b"};
+    strings.push_front("a");
+    for (int i = 0; i < 100; ++i) {
+        strings.push_back(*strings.begin());
+    }
+    compact_list<std::string> copy = strings;
+    strings.clear();
+    assert(strings.empty() && copy.size() == 102);
+    assert(*copy.rbegin() == "a" && *std::next(copy.begin()) == "b");
+    compact_list<std::string> moved = std::move(copy);
+    assert(moved.size() == 102 && copy.empty());
+
+    // A copy throwing while the array grows leaves every element in place
+    Accountant::reset();
+    {
+        compact_list<ThrowingAccountant> throwing;
+        for (int i = 0; i < 15; ++i) {
+            throwing.emplace_back(i);
+        }
+        size_t capacity = throwing.capacity();
+        ThrowingAccountant::need_throw = true;
+        bool thrown = false;
+        try {
+            throwing.reserve(capacity * 2);
+        } catch (std::string&) {
+            thrown = true;
+        }
+        ThrowingAccountant::need_throw = false;
+        assert(thrown && throwing.capacity() == capacity && throwing.size() == 15);
+        int expected = 0;
+        for (const ThrowingAccountant& elem : throwing) {
+            assert(elem.value == expected++);
+        }
+        throwing.reserve(capacity * 2);
+        assert(throwing.capacity() == capacity * 2 && throwing.begin()->value == 0);
+    }
+    assert(Accountant::ctor_calls == Accountant::dtor_calls);
+
+    // Nodes of ints take half the space of list's
+    size_t list_bytes = 0;
+    size_t compact_bytes = 0;
+    {
+        StackStorage<10'000'000> storage;
+        StackAllocator<int, 10'000'000> alloc(storage);
+        list<int, StackAllocator<int, 10'000'000>> lst(alloc);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        list_bytes = storage.used();
+    }
+    {
+        StackStorage<10'000'000> storage;
+        StackAllocator<int, 10'000'000> alloc(storage);
+        compact_list<int, StackAllocator<int, 10'000'000>> lst(alloc);
+        lst.reserve(100'000);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        compact_bytes = storage.used();
+        assert(lst.capacity() == 100'000);
+    }
+    assert(compact_bytes * 2 <= list_bytes + 64);
+
+    // Without reserve() the array stays on top of the arena and grows in place, so no
+    // abandoned smaller arrays are left below it
+    {
+        StackStorage<10'000'000> storage;
+        StackAllocator<int, 10'000'000> alloc(storage);
+        compact_list<int, StackAllocator<int, 10'000'000>> lst(alloc);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+        }
+        assert(storage.used() <= (lst.capacity() + 1) * 3 * sizeof(int) + 64);
+        assert(*lst.begin() == 0 && *lst.rbegin() == 99'999);
+    }
+}
+
+void TestRelocatableList() {
+    using Relocatable = list<int, OffsetAllocator<int>>;
+    constexpr size_t kBytes = 1 << 20;
+    std::vector<std::max_align_t> original(kBytes / sizeof(std::max_align_t));
+    std::vector<std::max_align_t> copy(kBytes / sizeof(std::max_align_t));
+
+    // The list object lives in the buffer next to its nodes
+    auto& storage = RelocatableStackStorage::create(original.data(), kBytes);
+    auto* lst = ::new (storage.allocate(sizeof(Relocatable), alignof(Relocatable)))
+                    Relocatable(OffsetAllocator<int>(storage));
+    storage.set_root(lst);
+
+    std::vector<int> values(1000);
+    std::iota(values.begin(), values.end(), 0);
+    std::shuffle(values.begin(), values.end(), std::mt19937(7));
+    lst->insert(lst->end(), values.begin(), values.end());
+    lst->sort();
+    lst->remove_if([](int value) { return value % 3 == 0; });
+    lst->pop_front();
+
+    std::vector<int> expected;
+    for (int value = 2; value < 1000; ++value) {
+        if (value % 3 != 0) {
+            expected.push_back(value);
+        }
+    }
+
+    std::memcpy(copy.data(), original.data(), storage.used());
+    std::memset(original.data(), 0, kBytes);
+    bool thrown = false;
+    try {
+        RelocatableStackStorage::attach(original.data());
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    auto& moved = RelocatableStackStorage::attach(copy.data());
+    auto& relocated = *static_cast<Relocatable*>(moved.root());
+    assert(relocated.size() == expected.size());
+    assert(std::equal(relocated.begin(), relocated.end(), expected.begin(), expected.end()));
+    assert(std::equal(relocated.rbegin(), relocated.rend(), expected.rbegin(), expected.rend()));
+
+    // New nodes come from the copy as well
+    relocated.push_front(1);
+    relocated.push_back(1000);
+    assert(*relocated.begin() == 1 && relocated.size() == expected.size() + 2);
+    auto first = reinterpret_cast<uintptr_t>(copy.data());
+    for (const int& value : relocated) {
+        auto address = reinterpret_cast<uintptr_t>(&value);
+        assert(address >= first && address < first + moved.used());
+    }
+    relocated.~Relocatable();
+}
+
+void TestSharedStorage() {
+    using Shared = list<int, OffsetAllocator<int>>;
+    const std::string name = "/stack_allocator_test_" + std::to_string(getpid());
+    SharedStackStorage::unlink(name);
+    {
+        SharedStackStorage writer(name, 1 << 20);
+        SharedStackStorage reader(name);
+        assert(writer.data() != reader.data());
+
+        RelocatableStackStorage& storage = writer.storage();
+        auto* lst = ::new (storage.allocate(sizeof(Shared), alignof(Shared)))
+                        Shared(OffsetAllocator<int>(storage));
+        for (int i = 0; i < 1000; ++i) {
+            lst->push_back(i);
+        }
+        storage.set_root(lst);
+
+        // The second mapping sees the same list and bumps the same cursor
+        auto& view = *static_cast<Shared*>(reader.storage().root());
+        assert(view.size() == 1000 && *view.rbegin() == 999);
+        view.push_back(1000);
+        assert(lst->size() == 1001 && *lst->rbegin() == 1000);
+        assert(reader.storage().used() == storage.used());
+
+        // Another process attaches by name and appends
+        pid_t child = fork();
+        if (child == 0) {
+            SharedStackStorage attached(name);
+            auto& remote = *static_cast<Shared*>(attached.storage().root());
+            bool ok = remote.size() == 1001 && std::equal(remote.begin(), remote.end(), lst->begin());
+            remote.push_back(1001);
+            _exit(ok ? 0 : 1);
+        }
+        int status = 0;
+        waitpid(child, &status, 0);
+        assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+        assert(lst->size() == 1002 && *lst->rbegin() == 1001);
+
+        // Threads allocating through both mappings never get overlapping blocks
+        size_t before = storage.used();
+        auto fill = [](RelocatableStackStorage& target, uint64_t tag) {
+            for (uint64_t i = 0; i < 10'000; ++i) {
+                *static_cast<uint64_t*>(target.allocate(sizeof(uint64_t), alignof(uint64_t))) = tag + i;
+            }
+        };
+        std::thread first(fill, std::ref(writer.storage()), 0);
+        fill(reader.storage(), 1'000'000);
+        first.join();
+        assert(storage.used() == before + 20'000 * sizeof(uint64_t));
+        auto* blocks = reinterpret_cast<uint64_t*>(static_cast<char*>(writer.data()) + before);
+        std::vector<uint64_t> tags(blocks, blocks + 20'000);
+        std::sort(tags.begin(), tags.end());
+        assert(std::adjacent_find(tags.begin(), tags.end()) == tags.end());
+        assert(tags.front() == 0 && tags.back() == 1'009'999);
+
+        lst->~Shared();
+    }
+    SharedStackStorage::unlink(name);
+
+    bool thrown = false;
+    try {
+        SharedStackStorage removed(name);
+    } catch (const std::system_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void TestSnapshot() {
+    using Snapshotted = list<int, OffsetAllocator<int>>;
+    const std::string path = (std::filesystem::temp_directory_path()
+                              / ("stack_allocator_snapshot_" + std::to_string(getpid()))).string();
+    constexpr int kElements = 1'000'000;
+    constexpr size_t kBytes = 64 << 20;
+
+    using namespace std::chrono;
+    long long rebuild = 0;
+    {
+        std::vector<std::max_align_t> buffer(kBytes / sizeof(std::max_align_t));
+        auto& storage = RelocatableStackStorage::create(buffer.data(), kBytes);
+        auto start = steady_clock::now();
+        auto* numbers = ::new (storage.allocate(sizeof(Snapshotted), alignof(Snapshotted)))
+                            Snapshotted(OffsetAllocator<int>(storage));
+        for (int i = 0; i < kElements; ++i) {
+            numbers->push_back(i);
+        }
+        rebuild = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        auto* sum = ::new (storage.allocate(sizeof(long long), alignof(long long)))
+                        long long(std::accumulate(numbers->begin(), numbers->end(), 0LL));
+        storage.set_root("numbers", numbers);
+        storage.set_root("sum", sum);
+        storage.save(path);
+    }
+
+    auto start = steady_clock::now();
+    {
+        StackStorageSnapshot snapshot(path);
+        const auto& numbers = *snapshot.root<Snapshotted>("numbers");
+        assert(numbers.size() == kElements);
+        assert(std::accumulate(numbers.begin(), numbers.end(), 0LL) == *snapshot.root<long long>("sum"));
+        assert(snapshot.root<void>("missing") == nullptr);
+    }
+    auto warm = duration_cast<milliseconds>(steady_clock::now() - start).count();
+    std::cerr << " Start with " << kElements << " elements: rebuild " << rebuild << " ms, snapshot " << warm
+              << " ms" << std::endl;
+
+    // Copy-on-write: the list keeps growing into the headroom, the file stays as it was
+    {
+        CopyOnWriteStackStorageSnapshot snapshot(path, 1 << 20);
+        auto& numbers = *snapshot.root<Snapshotted>("numbers");
+        numbers.pop_front();
+        for (int i = 0; i < 10'000; ++i) {
+            numbers.push_back(kElements + i);
+        }
+        assert(numbers.size() == kElements + 9'999 && *numbers.begin() == 1);
+        assert(snapshot.storage().used() > snapshot.storage().size() - (1 << 20));
+    }
+    {
+        StackStorageSnapshot snapshot(path);
+        const auto& numbers = *snapshot.root<Snapshotted>("numbers");
+        assert(numbers.size() == kElements && *numbers.begin() == 0);
+    }
+    // Read-only snapshots are mapped PROT_READ, so they neither take headroom nor hand out
+    // anything writable
+    static_assert(!std::is_constructible_v<StackStorageSnapshot, std::string, size_t>);
+    static_assert(std::is_same_v<decltype(std::declval<StackStorageSnapshot&>().root<int>()), const int*>);
+    static_assert(std::is_same_v<decltype(std::declval<StackStorageSnapshot&>().storage()),
+                                 const RelocatableStackStorage&>);
+    static_assert(std::is_same_v<decltype(std::declval<CopyOnWriteStackStorageSnapshot&>().root<int>()), int*>);
+    std::remove(path.c_str());
+
+    // The root table holds a fixed number of entries; removing one frees its slot
+    std::vector<std::max_align_t> buffer(4096 / sizeof(std::max_align_t));
+    auto& storage = RelocatableStackStorage::create(buffer.data(), 4096);
+    std::vector<int> objects(RelocatableStackStorage::kMaxRoots + 1);
+    for (size_t i = 0; i < RelocatableStackStorage::kMaxRoots; ++i) {
+        storage.set_root("root " + std::to_string(i), &objects[i]);
+    }
+    bool thrown = false;
+    try {
+        storage.set_root("one too many", &objects.back());
+    } catch (const std::length_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    storage.set_root("root 3", nullptr);
+    storage.set_root("one too many", &objects.back());
+    assert(storage.root("root 3") == nullptr && storage.root("one too many") == &objects.back());
+    assert(storage.root("root 7") == &objects[7]);
+}
+
+void TestBinarySerialization() {
+    const std::string path = (std::filesystem::temp_directory_path()
+                              / ("stack_allocator_binary_" + std::to_string(getpid()))).string();
+    constexpr int kElements = 1'000'000;
+    constexpr double kBytes = kElements * sizeof(int);
+    list<int> original;
+    for (int i = 0; i < kElements; ++i) {
+        original.push_back(i * 7);
+    }
+
+    using namespace std::chrono;
+    auto gigabytes_per_second = [kBytes](steady_clock::time_point start) {
+        return kBytes / duration_cast<duration<double>>(steady_clock::now() - start).count() / 1e9;
+    };
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    assert(fd != -1);
+    auto start = steady_clock::now();
+    write_binary(fd, original);
+    double write_speed = gigabytes_per_second(start);
+
+    MappedStackStorage storage(64 << 20);
+    StackAllocator<int, 0> alloc(storage);
+    list<int, StackAllocator<int, 0>> restored(alloc);
+    restored.push_back(-1);
+    lseek(fd, 0, SEEK_SET);
+    start = steady_clock::now();
+    read_binary(fd, restored);
+    double read_speed = gigabytes_per_second(start);
+    assert(restored.size() == kElements + 1 && *restored.begin() == -1);
+    assert(std::equal(std::next(restored.begin()), restored.end(), original.begin(), original.end()));
+
+    // Another element type or a cut payload is rejected and the list stays as it was
+    lseek(fd, 0, SEEK_SET);
+    list<long long> wider = {1, 2};
+    bool thrown = false;
+    try {
+        read_binary(fd, wider);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    assert(thrown && wider.size() == 2);
+    assert(ftruncate(fd, sizeof(ListBinaryHeader) + 100) == 0);
+    lseek(fd, 0, SEEK_SET);
+    thrown = false;
+    try {
+        read_binary(fd, restored);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown && restored.size() == kElements + 1);
+
+    // Large elements are gathered from the nodes themselves, over more than IOV_MAX pieces
+    struct Page {
+        int number;
+        char bytes[kGatheredElementSize];
+    };
+    list<Page> pages;
+    for (int i = 0; i < 3000; ++i) {
+        pages.push_back(Page{i, {}});
+        std::fill(std::begin(pages.rbegin()->bytes), std::end(pages.rbegin()->bytes), static_cast<char>(i));
+    }
+    assert(ftruncate(fd, 0) == 0);
+    lseek(fd, 0, SEEK_SET);
+    write_binary(fd, pages);
+    lseek(fd, 0, SEEK_SET);
+    list<Page> pages_copy;
+    read_binary(fd, pages_copy);
+    assert(pages_copy.size() == pages.size());
+    assert(std::equal(pages_copy.begin(), pages_copy.end(), pages.begin(), [](const Page& lhs, const Page& rhs) {
+        return lhs.number == rhs.number && std::memcmp(lhs.bytes, rhs.bytes, sizeof(lhs.bytes)) == 0;
+    }));
+    close(fd);
+
+    // The usual way: one stream call per element
+    start = steady_clock::now();
+    {
+        std::ofstream out(path, std::ios::binary);
+        size_t count = original.size();
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const int& value : original) {
+            out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+        }
+    }
+    double stream_write_speed = gigabytes_per_second(start);
+    start = steady_clock::now();
+    list<int> streamed;
+    {
+        std::ifstream in(path, std::ios::binary);
+        size_t count = 0;
+        in.read(reinterpret_cast<char*>(&count), sizeof(count));
+        for (size_t i = 0; i < count; ++i) {
+            int value = 0;
+            in.read(reinterpret_cast<char*>(&value), sizeof(value));
+            streamed.push_back(value);
+        }
+    }
+    double stream_read_speed = gigabytes_per_second(start);
+    assert(std::equal(streamed.begin(), streamed.end(), original.begin(), original.end()));
+    std::remove(path.c_str());
+
+    std::cerr << " Serializing " << kElements << " ints, GB/s: writev " << write_speed << ", iostream "
+              << stream_write_speed << "; reading back: bulk " << read_speed << ", iostream "
+              << stream_read_speed << std::endl;
+}
+
+void TestIndexedList() {
+    std::mt19937 gen(11);
+    indexed_list<int> indexed = {0, 1, 2};
+    std::vector<int> reference = {0, 1, 2};
+    for (int step = 0; step < 20'000; ++step) {
+        size_t index = gen() % (reference.size() + 1);
+        switch (gen() % 5) {
+        case 0:
+            indexed.push_back(step);
+            reference.push_back(step);
+            break;
+        case 1:
+            indexed.push_front(step);
+            reference.insert(reference.begin(), step);
+            break;
+        case 2:
+            if (!reference.empty() && gen() % 2 == 0) {
+                indexed.pop_back();
+                reference.pop_back();
+            } else if (!reference.empty()) {
+                indexed.pop_front();
+                reference.erase(reference.begin());
+            }
+            break;
+        case 3:
+            if (index < reference.size()) {
+                indexed.erase(indexed.nth(index));
+                reference.erase(reference.begin() + index);
+            }
+            break;
+        default:
+            assert(*indexed.insert(indexed.nth(index), step) == step);
+            reference.insert(reference.begin() + index, step);
+        }
+
+        assert(indexed.size() == reference.size());
+        if (!reference.empty()) {
+            size_t probe = gen() % reference.size();
+            auto it = indexed.nth(probe);
+            assert(*it == reference[probe]);
+            assert(indexed.index_of(it) == probe);
+        }
+    }
+    assert(std::equal(indexed.begin(), indexed.end(), reference.begin(), reference.end()));
+    assert(indexed.nth(indexed.size()) == indexed.end() && indexed.index_of(indexed.end()) == indexed.size());
+
+    indexed_list<int> copy = indexed;
+    indexed.clear();
+    assert(indexed.empty() && copy.size() == reference.size());
+    for (size_t i = 0; i < reference.size(); i += 97) {
+        assert(*copy.nth(i) == reference[i]);
+    }
+    indexed = std::move(copy);
+    assert(indexed.size() == reference.size() && indexed.index_of(std::prev(indexed.end())) == reference.size() - 1);
+    indexed.erase(indexed.nth(10), indexed.nth(20));
+    reference.erase(reference.begin() + 10, reference.begin() + 20);
+    assert(std::equal(indexed.rbegin(), indexed.rend(), reference.rbegin(), reference.rend()));
+
+    // Paging through a long list: nth() against walking from begin()
+    constexpr int kElements = 100'000;
+    constexpr int kQueries = 200;
+    StackStorage<10'000'000> storage;
+    StackAllocator<int, 10'000'000> alloc(storage);
+    indexed_list<int, StackAllocator<int, 10'000'000>> pages(alloc);
+    list<int> plain;
+    for (int i = 0; i < kElements; ++i) {
+        pages.push_back(i);
+        plain.push_back(i);
+    }
+    std::vector<size_t> queries(kQueries);
+    for (size_t& query : queries) {
+        query = gen() % kElements;
+    }
+
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    long long indexed_sum = 0;
+    for (size_t query : queries) {
+        indexed_sum += *pages.nth(query);
+    }
+    auto indexed_time = duration_cast<microseconds>(steady_clock::now() - start).count();
+    start = steady_clock::now();
+    long long walked_sum = 0;
+    for (size_t query : queries) {
+        walked_sum += *std::next(plain.begin(), query);
+    }
+    auto walk_time = duration_cast<microseconds>(steady_clock::now() - start).count();
+    assert(indexed_sum == walked_sum);
+    std::cerr << " " << kQueries << " lookups by position in " << kElements << " elements: nth() "
+              << indexed_time << " us, std::next " << walk_time << " us" << std::endl;
+}
+
+void TestReverse() {
+    std::mt19937 gen(13);
+    list<int> lst;
+    std::list<int> reference;
+    auto check = [&lst, &reference]() {
+        assert(lst.size() == reference.size());
+        assert(std::equal(lst.begin(), lst.end(), reference.begin(), reference.end()));
+        assert(std::equal(lst.rbegin(), lst.rend(), reference.rbegin(), reference.rend()));
+    };
+
+    for (int step = 0; step < 5'000; ++step) {
+        size_t index = gen() % (reference.size() + 1);
+        switch (gen() % 6) {
+        case 0:
+            lst.reverse();
+            reference.reverse();
+            break;
+        case 1:
+            lst.push_back(step);
+            reference.push_back(step);
+            break;
+        case 2:
+            lst.push_front(step);
+            reference.push_front(step);
+            break;
+        case 3:
+            if (reference.size() >= 2) {
+                lst.pop_back();
+                reference.pop_back();
+                lst.pop_front();
+                reference.pop_front();
+            }
+            break;
+        case 4:
+            if (index < reference.size()) {
+                auto next = lst.erase(std::next(lst.cbegin(), index));
+                auto reference_next = reference.erase(std::next(reference.cbegin(), index));
+                assert((next == lst.end()) == (reference_next == reference.end()));
+                assert(next == lst.end() || *next == *reference_next);
+            }
+            break;
+        default:
+            assert(*lst.insert(std::next(lst.cbegin(), index), step) == step);
+            reference.insert(std::next(reference.cbegin(), index), step);
+        }
+    }
+    check();
+
+    // Range insertion, assignment and copies follow the current orientation
+    lst.reverse();
+    reference.reverse();
+    std::vector<int> values = {-1, -2, -3, -4};
+    assert(*lst.insert(std::next(lst.cbegin(), 3), values.begin(), values.end()) == -1);
+    reference.insert(std::next(reference.cbegin(), 3), values.begin(), values.end());
+    lst.insert(lst.cend(), 2, -5);
+    reference.insert(reference.cend(), 2, -5);
+    check();
+    list<int> copy = lst;
+    assert(std::equal(copy.begin(), copy.end(), reference.begin(), reference.end()));
+    copy.reverse();
+    copy = lst;
+    assert(std::equal(copy.begin(), copy.end(), reference.begin(), reference.end()));
+
+    // Operations that walk next links on a reversed list
+    lst.reverse();
+    reference.reverse();
+    lst.sort();
+    reference.sort();
+    check();
+    lst.reverse();
+    reference.reverse();
+    size_t before = reference.size();
+    reference.unique();
+    assert(lst.unique() == before - reference.size());
+    check();
+    list<int> other = {1, 2, 3};
+    std::list<int> reference_other = {1, 2, 3};
+    other.reverse();
+    reference_other.reverse();
+    lst.splice(std::next(lst.cbegin()), other, other.cbegin(), std::next(other.cbegin(), 2));
+    reference.splice(std::next(reference.cbegin()), reference_other, reference_other.cbegin(),
+                     std::next(reference_other.cbegin(), 2));
+    check();
+    assert(other.size() == 1 && *other.begin() == 1);
+    lst.swap(other);
+    lst.swap(other);
+    check();
+
+    // Iterators made after reverse() keep walking forwards across splice and sort
+    {
+        list<int> a = {1, 2, 3, 4};
+        list<int> b = {5, 6};
+        a.reverse();
+        auto it = a.begin();
+        a.splice(a.end(), b);
+        ++it;
+        assert(*it == 3);
+        assert(std::equal(a.begin(), a.end(), std::vector<int>{4, 3, 2, 1, 5, 6}.begin()));
+
+        list<int> c = {5, 1, 3};
+        c.reverse();
+        auto jt = c.begin();
+        c.sort();
+        assert(*jt == 3 && *++jt == 5 && ++jt == c.end());
+        c.unique();
+        c.merge(list<int>{2, 4});
+        assert(*--jt == 5 && *--jt == 4);
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{1, 2, 3, 4, 5}.begin()));
+
+        // Single elements and ranges between lists of either orientation
+        list<int> d = {7, 8, 9};
+        d.reverse();
+        c.splice(std::next(c.begin()), d, std::next(d.begin()));
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{1, 8, 2, 3, 4, 5}.begin()));
+        c.reverse();
+        d.splice(d.end(), c, c.begin(), std::next(c.begin(), 2));
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{3, 2, 8, 1}.begin()));
+        assert(std::equal(d.begin(), d.end(), std::vector<int>{9, 7, 5, 4}.begin()));
+        c.reverse();
+        c.splice(c.begin(), d, std::next(d.begin()), d.end());
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{7, 5, 4, 1, 8, 2, 3}.begin()));
+        assert(d.size() == 1 && *d.begin() == 9);
+        c.splice(c.end(), c, c.begin(), std::next(c.begin(), 3));
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{1, 8, 2, 3, 7, 5, 4}.begin()));
+        assert(std::equal(c.rbegin(), c.rend(), std::vector<int>{4, 5, 7, 3, 2, 8, 1}.begin()));
+
+        // Splicing a range of the list before its own end or first element changes nothing
+        auto first = std::next(c.begin());
+        auto last = std::next(first, 3);
+        c.splice(last, c, first, last);
+        c.splice(first, c, first, last);
+        c.splice(first, c, first, std::next(first));
+        assert(std::equal(c.begin(), c.end(), std::vector<int>{1, 8, 2, 3, 7, 5, 4}.begin()));
+        assert(std::equal(c.rbegin(), c.rend(), std::vector<int>{4, 5, 7, 3, 2, 8, 1}.begin()));
+    }
+
+    // Reversing is O(1) regardless of length
+    list<int> longer(1'000'000, 0);
+    std::list<int> reference_longer(1'000'000, 0);
+    using namespace std::chrono;
+    auto start = steady_clock::now();
+    for (int i = 0; i < 11; ++i) {
+        longer.reverse();
+    }
+    auto flag_time = duration_cast<microseconds>(steady_clock::now() - start).count();
+    start = steady_clock::now();
+    for (int i = 0; i < 11; ++i) {
+        reference_longer.reverse();
+    }
+    auto relink_time = duration_cast<microseconds>(steady_clock::now() - start).count();
+    std::cerr << " 11 reversals of 1000000 elements: list " << flag_time << " us, std::list " << relink_time
+              << " us" << std::endl;
+}
+
+void TestMpscQueue() {
+    using namespace std::chrono;
+    using Item = std::pair<unsigned, int>; // producer, sequence number
+    using Alloc = ConcurrentStackAllocator<Item, STORAGE_SIZE>;
+
+    constexpr int kItemsPerProducer = 100'000;
+    const unsigned max_producers = MaxBenchmarkThreads();
+    std::ostringstream queue_oss;
+    std::ostringstream mutex_oss;
+
+    for (unsigned producers = 1; producers <= max_producers; producers *= 2) {
+        const size_t total = size_t(producers) * kItemsPerProducer;
+
+        {
+            StackRegion region(STATIC_STORAGE);
+            mpsc_queue<Item, Alloc> queue{Alloc(STATIC_STORAGE)};
+            assert(queue.empty());
+            std::vector<std::thread> workers;
+
+            auto start = high_resolution_clock::now();
+            for (unsigned p = 0; p < producers; ++p) {
+                workers.emplace_back([&, p] {
+                    for (int i = 0; i < kItemsPerProducer; ++i) {
+                        queue.emplace(p, i);
+                    }
+                });
+            }
+            // Every producer's items must arrive in the order it pushed them
+            std::vector<int> expected(producers, 0);
+            Item item;
+            for (size_t popped = 0; popped < total;) {
+                if (!queue.try_pop(item)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                assert(item.second == expected[item.first]);
+                ++expected[item.first];
+                ++popped;
+            }
+            auto finish = high_resolution_clock::now();
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            assert(queue.empty() && !queue.try_pop(item));
+            queue_oss << producers << ": " << static_cast<long>(total / duration<double>(finish - start).count()) << " ";
+        }
+
+        std::mutex mutex;
+        list<Item> locked;
+        std::vector<std::thread> workers;
+
+        auto start = high_resolution_clock::now();
+        for (unsigned p = 0; p < producers; ++p) {
+            workers.emplace_back([&, p] {
+                for (int i = 0; i < kItemsPerProducer; ++i) {
+                    std::lock_guard lock(mutex);
+                    locked.emplace_back(p, i);
+                }
+            });
+        }
+        for (size_t popped = 0; popped < total;) {
+            std::unique_lock lock(mutex);
+            if (locked.size() == 0) {
+                lock.unlock();
+                std::this_thread::yield();
+                continue;
+            }
+            locked.pop_front();
+            ++popped;
+        }
+        auto finish = high_resolution_clock::now();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        mutex_oss << producers << ": " << static_cast<long>(total / duration<double>(finish - start).count()) << " ";
+    }
+
+    // Consumed nodes go back to the producers, so a queue on the arena stops growing once
+    // it has seen its largest backlog
+    {
+        StackStorage<1 << 20> storage;
+        mpsc_queue<Item, ConcurrentStackAllocator<Item, 1 << 20>> queue{ConcurrentStackAllocator<Item, 1 << 20>(storage)};
+        size_t settled = 0;
+        Item item;
+        for (int round = 1; round <= 100; ++round) {
+            for (int i = 0; i < 1000; ++i) {
+                queue.emplace(0u, i);
+            }
+            for (int i = 0; i < 1000; ++i) {
+                assert(queue.try_pop(item) && item.second == i);
+            }
+            if (round == 10) {
+                settled = storage.used();
+            }
+        }
+        assert(storage.used() == settled);
+    }
+
+    // Elements left behind are destroyed with the queue
+    {
+        mpsc_queue<std::string> queue;
+        for (int i = 0; i < 1000; ++i) {
+            queue.push(std::to_string(i));
+        }
+        std::string value;
+        for (int i = 0; i < 500; ++i) {
+            assert(queue.try_pop(value) && value == std::to_string(i));
+        }
+    }
+
+    std::cerr << " MPSC transfers per second by producer count: mpsc_queue " << queue_oss.str()
+              << "| mutex + list " << mutex_oss.str() << std::endl;
+}
+
+void TestConcurrentAllocation() {
+    using namespace std::chrono;
+
+    constexpr int kAllocationsPerThread = 200'000;
+    const unsigned max_threads = MaxBenchmarkThreads();
+
+    ConcurrentStackAllocator<uint64_t, STORAGE_SIZE> alloc(STATIC_STORAGE);
+    std::ostringstream oss;
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        StackRegion region(STATIC_STORAGE);
+        std::vector<std::vector<uint64_t*>> blocks(threads);
+        std::vector<std::thread> workers;
+
+        auto start = high_resolution_clock::now();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                blocks[t].reserve(kAllocationsPerThread);
+                for (int i = 0; i < kAllocationsPerThread; ++i) {
+                    uint64_t* block = alloc.allocate(1 + i % 3);
+                    *block = t;
+                    blocks[t].push_back(block);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        auto finish = high_resolution_clock::now();
+
+        // Blocks handed to different threads must not overlap
+        for (unsigned t = 0; t < threads; ++t) {
+            for (uint64_t* block : blocks[t]) {
+                assert(*block == t);
+                assert(reinterpret_cast<uintptr_t>(block) % alignof(uint64_t) == 0);
+            }
+        }
+
+        double seconds = duration<double>(finish - start).count();
+        oss << threads << ": " << static_cast<long>(threads * kAllocationsPerThread / seconds) << " ";
+    }
+
+    std::cerr << " Concurrent allocations per second by thread count: " << oss.str() << std::endl;
+}
+
+void TestThreadShards() {
+    using namespace std::chrono;
+
+    constexpr int kElementsPerThread = 200'000;
+    const unsigned max_threads = MaxBenchmarkThreads();
+    using Alloc = StackAllocator<int, STORAGE_SIZE>;
+
+    // A shard whose parent is exhausted fails like any other storage
+    {
+        StackStorage<4096> parent;
+        StackShard shard(parent, 1024);
+        size_t served = 0;
+        while (shard.try_allocate(64, 8) != nullptr) {
+            ++served;
+        }
+        assert(served >= 1024 / 64 && served <= 4096 / 64);
+        bool thrown = false;
+        try {
+            shard.allocate(64, 8);
+        } catch (std::bad_alloc&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    std::ostringstream oss;
+
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        StackRegion region(STATIC_STORAGE);
+        std::vector<std::thread> workers;
+        std::vector<long long> sums(threads);
+
+        auto start = high_resolution_clock::now();
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                StackShard shard(STATIC_STORAGE, 1 << 16);
+                list<int, Alloc> lst{Alloc(shard)};
+                for (int i = 0; i < kElementsPerThread; ++i) {
+                    lst.push_back(i);
+                }
+                for (int x : lst) {
+                    sums[t] += x;
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        auto finish = high_resolution_clock::now();
+
+        for (long long sum : sums) {
+            assert(sum == 1ll * kElementsPerThread * (kElementsPerThread - 1) / 2);
+        }
+
+        double seconds = duration<double>(finish - start).count();
+        oss << threads << ": " << static_cast<long>(threads * kElementsPerThread / seconds) << " ";
+    }
+
+    std::cerr << " Sharded push_backs per second by thread count: " << oss.str() << std::endl;
+}
+
 template <typename Alloc>
 void DequeTest() {
     Alloc alloc(STATIC_STORAGE);
@@ -541,6 +2304,57 @@ void TestPerformance() {
 
 
 
+void TestPoolAllocator() {
+    {
+        PoolAllocator<int> alloc;
+        list<int, PoolAllocator<int>> lst(alloc);
+        for (int i = 0; i < 100'000; ++i) {
+            lst.push_back(i);
+            if (i % 3 == 0) {
+                lst.pop_front();
+            }
+        }
+        assert(lst.size() == 66'666);
+        assert(lst.get_allocator() == alloc);
+
+        auto copy = lst;
+        assert(copy.size() == lst.size() && *copy.rbegin() == 99'999);
+    }
+    {
+        StackStorage<200'000> storage;
+        PoolAllocator<int> alloc(storage);
+        list<int, PoolAllocator<int>> lst(alloc);
+        for (int i = 0; i < 1'000'000; ++i) {
+            lst.push_back(i);
+            lst.pop_front();
+        }
+        assert(storage.used() <= NodePool::kSlabSize + 64);
+    }
+
+    double std_time = 0.0;
+    double stack_time = 0.0;
+    double pool_time = 0.0;
+    for (int i = 0; i < 3; ++i) {
+        std_time += ListPerformanceTest(list<int, std::allocator<int>>());
+
+        {
+            StackStorage<STORAGE_SIZE> storage;
+            StackAllocator<int, STORAGE_SIZE> alloc(storage);
+            stack_time += ListPerformanceTest(list<int, StackAllocator<int, STORAGE_SIZE>>(alloc));
+        }
+
+        StackRegion region(STATIC_STORAGE);
+        pool_time += ListPerformanceTest(list<int, PoolAllocator<int>>(PoolAllocator<int>(STATIC_STORAGE)));
+    }
+
+    std::cerr << " Mean times with std::allocator: " << std_time / 3 << " ms, StackAllocator: " << stack_time / 3
+              << " ms, PoolAllocator: " << pool_time / 3 << " ms" << std::endl;
+
+    if (std_time * 0.9 < pool_time) {
+        throw std::runtime_error("PoolAllocator expected to be at least 10% faster than std::allocator");
+    }
+}
+
 int main() {
 
     const rlim_t kStackSize = 300 * 1024 * 1024;   // min stack size = 16 MB
@@ -623,7 +2437,108 @@ int main() {
     TestWhimsicalAllocator();
     
     std::cerr << "Test 7 (Allocator Awareness) passed." << std::endl;
+
+    TestMemoryReuse();
+
+    std::cerr << "Test 8 (MemoryReuse) passed." << std::endl;
+
+    TestScopedRegion();
+
+    std::cerr << "Test 9 (ScopedRegion) passed." << std::endl;
+
+    TestConcurrentAllocation();
+
+    std::cerr << "Test 10 (ConcurrentAllocation) passed." << std::endl;
+
+    TestThreadShards();
+
+    std::cerr << "Test 11 (ThreadShards) passed." << std::endl;
+
+    TestOverflow();
+
+    std::cerr << "Test 12 (Overflow) passed." << std::endl;
+
+    TestMemoryResource();
+
+    std::cerr << "Test 13 (MemoryResource) passed." << std::endl;
+
+    TestMappedStorage();
+
+    std::cerr << "Test 14 (MappedStorage) passed." << std::endl;
+
+    TestMoveSemantics();
+
+    std::cerr << "Test 15 (MoveSemantics) passed." << std::endl;
+
+    TestNodeCache();
+
+    std::cerr << "Test 16 (NodeCache) passed." << std::endl;
+
+#ifdef STACK_ALLOCATOR_STATS
+    TestStatistics();
+
+    std::cerr << "Test 17 (Statistics) passed." << std::endl;
+#else
+    std::cerr << "Test 17 (Statistics) skipped, build with -DSTACK_ALLOCATOR_STATS to run it." << std::endl;
+#endif
+
+    TestBatchInsertion();
+
+    std::cerr << "Test 18 (BatchInsertion) passed." << std::endl;
+
+    TestClear();
+
+    std::cerr << "Test 19 (Clear) passed." << std::endl;
+
+    TestSort();
+
+    std::cerr << "Test 20 (Sort) passed." << std::endl;
+
+    TestParallelSort();
+
+    std::cerr << "Test 21 (ParallelSort) passed." << std::endl;
+
+    TestSplice();
+
+    std::cerr << "Test 22 (Splice) passed." << std::endl;
+
+    TestUnrolledList();
+
+    std::cerr << "Test 23 (UnrolledList) passed." << std::endl;
+
+    TestCompactList();
+
+    std::cerr << "Test 24 (CompactList) passed." << std::endl;
+
+    TestRelocatableList();
+
+    std::cerr << "Test 25 (RelocatableList) passed." << std::endl;
+
+    TestSharedStorage();
+
+    std::cerr << "Test 26 (SharedStorage) passed." << std::endl;
+
+    TestSnapshot();
+
+    std::cerr << "Test 27 (Snapshot) passed." << std::endl;
+
+    TestBinarySerialization();
+
+    std::cerr << "Test 28 (BinarySerialization) passed." << std::endl;
+
+    TestIndexedList();
+
+    std::cerr << "Test 29 (IndexedList) passed." << std::endl;
+
+    TestReverse();
+
+    std::cerr << "Test 30 (Reverse) passed." << std::endl;
+
+    TestMpscQueue();
+
+    std::cerr << "Test 31 (MpscQueue) passed." << std::endl;
     
+#ifndef STACK_ALLOCATOR_STATS
     std::cerr << "Starting performance test. First, let's test performance of different allocators with std::list." << std::endl;
 
     TestPerformance<std::list>();
@@ -632,6 +2547,11 @@ int main() {
 
     TestPerformance<list>();
 
+    std::cerr << "Now the same with a node pool." << std::endl;
+
+    TestPoolAllocator();
+#endif
+
     std::cerr << "Tests passed, my sweetheart!" << std::endl;
 
     if (std::is_assignable_v<list<int>, std::list<int>> || std::is_assignable_v<std::list<int>, list<int>>) {
@@ -1,25 +1,624 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef STACK_ALLOCATOR_STATS
+// Usage counters of a StackStorageBase, compiled in only with STACK_ALLOCATOR_STATS.
+// allocate_concurrent() and reserve() are not accounted.
+struct StackStorageStatistics {
+  static constexpr size_t kSizeBuckets = 32;
+
+  size_t bytes_in_use = 0;        // requested bytes (rounded to the granularity) not yet released
+  size_t footprint = 0;           // bytes taken by the bump pointer, padding included
+  size_t high_water_mark = 0;     // largest footprint seen
+  size_t alignment_waste = 0;     // bytes skipped by the bump pointer to satisfy alignment
+  size_t allocations = 0;
+  size_t free_list_hits = 0;
+  size_t failed_allocations = 0;
+  size_t size_histogram[kSizeBuckets] = {}; // [i] counts allocations of [2^i, 2^(i+1)) bytes
+};
+#endif
+
+// Bump-pointer arena shared by every StackAllocator bound to it.
+// Released blocks of up to kMaxSmallBlock bytes are kept in per-size-class free lists
+// threaded through the blocks themselves, so steady push/pop churn reuses memory
+// instead of walking the bump pointer to the end of the storage.
+class StackStorageBase {
+public:
+  static constexpr size_t kGranularity = sizeof(void*);
+  static constexpr size_t kMaxSmallBlock = 256;
+  static constexpr size_t kSizeClasses = kMaxSmallBlock / kGranularity;
+
+  // Position of the bump pointer; see mark() and rewind()
+  class Marker {
+    char* begin_;
+    char* top_;
+    char* end_;
+    void* chunk_;
+#ifdef STACK_ALLOCATOR_STATS
+    size_t bytes_in_use_ = 0;
+    size_t footprint_ = 0;
+#endif
+    Marker(char* begin, char* top, char* end, void* chunk)
+        : begin_(begin), top_(top), end_(end), chunk_(chunk) {}
+    friend class StackStorageBase;
+  };
+
+  StackStorageBase(const StackStorageBase&) = delete;
+  StackStorageBase& operator=(const StackStorageBase&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment);
+  void deallocate(void* pointer, size_t bytes);
+
+  // Releases `count` blocks of `bytes` each, linked from `first` to `last` through a
+  // pointer stored in their first bytes. Leading blocks that sit at the top of the stack
+  // are popped, the rest of a small-block chain joins its free list in one step.
+  void deallocate_chain(void* first, void* last, size_t count, size_t bytes);
+
+  // Grows a block of `bytes` to `new_bytes` where it lies. Succeeds only for the block at
+  // the top of the stack, and only while the current buffer has room.
+  bool try_expand(void* pointer, size_t bytes, size_t new_bytes);
+
+  // Same as allocate(), but returns nullptr instead of throwing when out of memory
+  void* try_allocate(size_t bytes, size_t alignment);
+
+  // Whether `pointer` lies in memory handed out by this storage
+  virtual bool contains(const void* pointer) const;
+
+  // Thread-safe counterparts: the bump pointer is advanced with a compare-and-swap and
+  // free lists are not used. Must not run concurrently with allocate()/deallocate().
+  void* allocate_concurrent(size_t bytes, size_t alignment);
+  void* try_allocate_concurrent(size_t bytes, size_t alignment);
+  void deallocate_concurrent(void* pointer, size_t bytes);
+
+  // Releases everything allocated after `marker` was taken. The bump pointer moves back in
+  // O(1); the free lists are walked once to drop the blocks above the marker and keep the
+  // ones below it for reuse. Nothing allocated after the marker may be in use or released
+  // any more: a block deallocated above the rewound top would go to a free list while the
+  // bump pointer hands it out again.
+  Marker mark() const;
+  void rewind(Marker marker);
+  // Number of rewinds so far: memory a container kept across a change of it may be gone
+  size_t rewind_count() const { return rewinds_; }
+
+  // Instead of throwing std::bad_alloc once the storage is full, continue in heap chunks
+  // of geometrically growing size starting from `first_chunk_size` bytes. Chunks are freed
+  // by rewind(), which also shrinks the next chunk back, or together with the storage.
+  // allocate_concurrent() never overflows.
+  void enable_overflow(size_t first_chunk_size) {
+    first_chunk_size_ = first_chunk_size;
+    next_chunk_size_ = first_chunk_size;
+  }
+  size_t overflow_capacity() const { return overflow_capacity_; }
+
+  // Containers created while a StackRegion is innermost may skip releasing trivially
+  // destructible elements one by one and leave them to its rewind. region_depth() tells
+  // them whether a newer region has opened since.
+  void enter_region() { ++open_regions_; }
+  void leave_region() { --open_regions_; }
+  bool in_scoped_region() const { return open_regions_ != 0; }
+  size_t region_depth() const { return open_regions_; }
+
+  char* get_array() { return top_; }
+  void reserve(size_t n) { top_ += n; }
+
+  // Both refer to the buffer currently used for allocation
+  size_t capacity() const { return end_ - begin_; }
+  size_t used() const { return top_ - begin_; }
+
+#ifdef STACK_ALLOCATOR_STATS
+  const StackStorageStatistics& statistics() const { return statistics_; }
+#endif
+
+protected:
+  StackStorageBase(char* begin, size_t capacity)
+      : buffer_begin_(begin), buffer_end_(begin + capacity),
+        begin_(begin), top_(begin), end_(begin + capacity), top_block_(nullptr), top_padding_(0),
+        free_lists_{}, open_regions_(0), rewinds_(0),
+        chunks_(nullptr), first_chunk_size_(0), next_chunk_size_(0), overflow_capacity_(0)
+#ifdef STACK_ALLOCATOR_STATS
+        , statistics_()
+#endif
+  {}
+
+  virtual ~StackStorageBase() { release_chunks(nullptr); }
+
+  // Called when the current buffer cannot fit a request. An implementation may
+  // switch the storage to a fresh buffer with reset_buffer() and return true.
+  virtual bool refill(size_t bytes, size_t alignment);
+
+  char* initial_buffer() const { return buffer_begin_; }
+
+  void reset_buffer(char* begin, size_t capacity) {
+    begin_ = begin;
+    top_ = begin;
+    end_ = begin + capacity;
+    top_block_ = nullptr;
+  }
+
+private:
+  void* allocate_slow(size_t bytes, size_t alignment);
+  // Hands out `block`, which lies at or above top_ in the current buffer
+  void* bump(char* block, size_t bytes);
+
+  // Header of an overflow chunk, followed by its usable memory
+  struct alignas(std::max_align_t) OverflowChunk {
+    OverflowChunk* previous;
+    size_t size;
+  };
+
+  void release_chunks(void* last_kept);
+
+  // Accounting hooks, no-ops unless STACK_ALLOCATOR_STATS is defined. `popped` is what
+  // a deallocation gave back to the bump pointer, padding included.
+  void note_allocation(size_t bytes, size_t padding);
+  void note_reuse(size_t bytes);
+  void note_deallocation(size_t bytes, size_t popped);
+  void note_expansion(size_t bytes);
+  void note_failure();
+#ifdef STACK_ALLOCATOR_STATS
+  void note_request(size_t bytes);
+#endif
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  static size_t round_up(size_t bytes) {
+    return bytes == 0 ? kGranularity : (bytes + kGranularity - 1) & ~(kGranularity - 1);
+  }
+
+  static bool is_aligned(const void* pointer, size_t alignment) {
+    return (reinterpret_cast<uintptr_t>(pointer) & (alignment - 1)) == 0;
+  }
+
+  static uintptr_t align_up(const char* pointer, size_t alignment) {
+    return (reinterpret_cast<uintptr_t>(pointer) + alignment - 1) & ~(alignment - 1);
+  }
+
+  char* buffer_begin_; // the buffer the storage was created with
+  char* buffer_end_;
+  char* begin_;
+  char* top_;
+  char* end_;
+  // The block ending at top_ if it was bumped by allocate(), and the alignment padding
+  // skipped before it, which popping the block gives back as well
+  char* top_block_;
+  size_t top_padding_;
+  FreeBlock* free_lists_[kSizeClasses]; // free_lists_[i] holds blocks of (i + 1) * kGranularity bytes
+  size_t open_regions_;
+  size_t rewinds_;
+  OverflowChunk* chunks_; // the most recent chunk first
+  size_t first_chunk_size_;
+  size_t next_chunk_size_;
+  size_t overflow_capacity_;
+#ifdef STACK_ALLOCATOR_STATS
+  StackStorageStatistics statistics_;
+#endif
+};
+
+inline void* StackStorageBase::allocate(size_t bytes, size_t alignment) {
+  void* block = try_allocate(bytes, alignment);
+  if (block == nullptr) [[unlikely]] {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+inline void* StackStorageBase::try_allocate(size_t bytes, size_t alignment) {
+  bytes = round_up(bytes);
+  if (bytes <= kMaxSmallBlock) {
+    FreeBlock*& head = free_lists_[bytes / kGranularity - 1];
+    if (head != nullptr && is_aligned(head, alignment)) {
+      FreeBlock* block = head;
+      head = block->next;
+      note_reuse(bytes);
+      return block;
+    }
+  }
+
+  void* top = top_;
+  size_t space = end_ - top_;
+  if (std::align(alignment, bytes, top, space) == nullptr) [[unlikely]] {
+    return allocate_slow(bytes, alignment);
+  }
+  return bump(static_cast<char*>(top), bytes);
+}
+
+inline void* StackStorageBase::allocate_slow(size_t bytes, size_t alignment) {
+  void* top = nullptr;
+  size_t space = 0;
+  do {
+    if (!refill(bytes, alignment)) {
+      note_failure();
+      return nullptr;
+    }
+    top = top_;
+    space = end_ - top_;
+  } while (std::align(alignment, bytes, top, space) == nullptr);
+  return bump(static_cast<char*>(top), bytes);
+}
+
+inline void* StackStorageBase::bump(char* block, size_t bytes) {
+  size_t padding = block - top_;
+  note_allocation(bytes, padding);
+  top_block_ = block;
+  top_padding_ = padding;
+  top_ = block + bytes;
+  return block;
+}
+
+inline void StackStorageBase::deallocate(void* pointer, size_t bytes) {
+  bytes = round_up(bytes);
+  char* block = static_cast<char*>(pointer);
+
+  // The most recent allocation is simply popped off the stack
+  if (block + bytes == top_) {
+    size_t padding = block == top_block_ ? top_padding_ : 0;
+    top_ = block - padding;
+    top_block_ = nullptr;
+    note_deallocation(bytes, bytes + padding);
+    return;
+  }
+
+  note_deallocation(bytes, 0);
+  if (bytes <= kMaxSmallBlock && is_aligned(block, alignof(FreeBlock))) {
+    FreeBlock*& head = free_lists_[bytes / kGranularity - 1];
+    head = ::new (block) FreeBlock{head};
+  }
+  // Large blocks in the middle of the stack are not recycled
+}
+
+inline void StackStorageBase::deallocate_chain(void* first, void* last, size_t count, size_t bytes) {
+  bytes = round_up(bytes);
+  void* block = first;
+  for (; count != 0 && static_cast<char*>(block) + bytes == top_; --count) {
+    void* next;
+    std::memcpy(&next, block, sizeof(next));
+    deallocate(block, bytes);
+    block = next;
+  }
+  if (count == 0) {
+    return;
+  }
+
+  if (bytes <= kMaxSmallBlock) {
+    // The chain's own links become the free list links, only its last block is rewritten
+    note_deallocation(count * bytes, 0);
+    FreeBlock*& head = free_lists_[bytes / kGranularity - 1];
+    ::new (last) FreeBlock{head};
+    head = static_cast<FreeBlock*>(block);
+    return;
+  }
+  for (; count != 0; --count) {
+    void* next;
+    std::memcpy(&next, block, sizeof(next));
+    deallocate(block, bytes);
+    block = next;
+  }
+}
+
+inline bool StackStorageBase::try_expand(void* pointer, size_t bytes, size_t new_bytes) {
+  bytes = round_up(bytes);
+  new_bytes = round_up(new_bytes);
+  char* block = static_cast<char*>(pointer);
+  if (block + bytes != top_ || new_bytes < bytes || new_bytes > static_cast<size_t>(end_ - block)) {
+    return false;
+  }
+  note_expansion(new_bytes - bytes);
+  top_ = block + new_bytes;
+  return true;
+}
+
+#ifdef STACK_ALLOCATOR_STATS
+inline void StackStorageBase::note_request(size_t bytes) {
+  ++statistics_.allocations;
+  statistics_.bytes_in_use += bytes;
+  size_t bucket = std::min<size_t>(std::bit_width(bytes) - 1, StackStorageStatistics::kSizeBuckets - 1);
+  ++statistics_.size_histogram[bucket];
+}
+
+inline void StackStorageBase::note_reuse(size_t bytes) {
+  note_request(bytes);
+  ++statistics_.free_list_hits;
+}
+
+inline void StackStorageBase::note_allocation(size_t bytes, size_t padding) {
+  note_request(bytes);
+  statistics_.alignment_waste += padding;
+  statistics_.footprint += padding + bytes;
+  statistics_.high_water_mark = std::max(statistics_.high_water_mark, statistics_.footprint);
+}
+
+inline void StackStorageBase::note_deallocation(size_t bytes, size_t popped) {
+  statistics_.bytes_in_use -= bytes;
+  statistics_.footprint -= popped;
+}
+
+inline void StackStorageBase::note_expansion(size_t bytes) {
+  statistics_.bytes_in_use += bytes;
+  statistics_.footprint += bytes;
+  statistics_.high_water_mark = std::max(statistics_.high_water_mark, statistics_.footprint);
+}
+
+inline void StackStorageBase::note_failure() {
+  ++statistics_.failed_allocations;
+}
+#else
+inline void StackStorageBase::note_allocation(size_t, size_t) {}
+inline void StackStorageBase::note_reuse(size_t) {}
+inline void StackStorageBase::note_deallocation(size_t, size_t) {}
+inline void StackStorageBase::note_expansion(size_t) {}
+inline void StackStorageBase::note_failure() {}
+#endif
+
+inline void* StackStorageBase::allocate_concurrent(size_t bytes, size_t alignment) {
+  void* block = try_allocate_concurrent(bytes, alignment);
+  if (block == nullptr) [[unlikely]] {
+    throw std::bad_alloc();
+  }
+  return block;
+}
+
+inline void* StackStorageBase::try_allocate_concurrent(size_t bytes, size_t alignment) {
+  bytes = round_up(bytes);
+  std::atomic_ref<char*> top(top_);
+  char* current = top.load(std::memory_order_relaxed);
+  uintptr_t result = 0;
+
+  // Padding is recomputed from the freshly observed top on every retry
+  do {
+    result = align_up(current, alignment);
+    if (result + bytes > reinterpret_cast<uintptr_t>(end_)) {
+      return nullptr;
+    }
+  } while (!top.compare_exchange_weak(current, reinterpret_cast<char*>(result + bytes),
+                                      std::memory_order_relaxed));
+
+  return reinterpret_cast<void*>(result);
+}
+
+inline void StackStorageBase::deallocate_concurrent(void* pointer, size_t bytes) {
+  char* block = static_cast<char*>(pointer);
+  char* expected = block + round_up(bytes);
+  std::atomic_ref<char*>(top_).compare_exchange_strong(expected, block, std::memory_order_relaxed);
+}
+
+inline bool StackStorageBase::refill(size_t bytes, size_t alignment) {
+  if (next_chunk_size_ == 0) {
+    return false;
+  }
+
+  size_t size = std::max(next_chunk_size_, bytes + alignment);
+  auto* chunk = static_cast<OverflowChunk*>(::operator new(sizeof(OverflowChunk) + size));
+  chunk->previous = chunks_;
+  chunk->size = size;
+  chunks_ = chunk;
+
+  next_chunk_size_ = size * 2;
+  overflow_capacity_ += size;
+  reset_buffer(reinterpret_cast<char*>(chunk + 1), size);
+  return true;
+}
+
+inline void StackStorageBase::release_chunks(void* last_kept) {
+  while (chunks_ != last_kept) {
+    OverflowChunk* previous = chunks_->previous;
+    overflow_capacity_ -= chunks_->size;
+    ::operator delete(chunks_);
+    chunks_ = previous;
+  }
+}
+
+inline bool StackStorageBase::contains(const void* pointer) const {
+  auto address = reinterpret_cast<uintptr_t>(pointer);
+  if (address >= reinterpret_cast<uintptr_t>(buffer_begin_) && address < reinterpret_cast<uintptr_t>(buffer_end_)) {
+    return true;
+  }
+  for (const OverflowChunk* chunk = chunks_; chunk != nullptr; chunk = chunk->previous) {
+    auto chunk_begin = reinterpret_cast<uintptr_t>(chunk + 1);
+    if (address >= chunk_begin && address < chunk_begin + chunk->size) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline auto StackStorageBase::mark() const -> Marker {
+  Marker marker(begin_, top_, end_, chunks_);
+#ifdef STACK_ALLOCATOR_STATS
+  marker.bytes_in_use_ = statistics_.bytes_in_use;
+  marker.footprint_ = statistics_.footprint;
+#endif
+  return marker;
+}
+
+inline void StackStorageBase::rewind(Marker marker) {
+#ifdef STACK_ALLOCATOR_STATS
+  statistics_.bytes_in_use = std::min(statistics_.bytes_in_use, marker.bytes_in_use_);
+  statistics_.footprint = marker.footprint_;
+#endif
+  if (chunks_ != marker.chunk_) {
+    release_chunks(marker.chunk_);
+    // Continue growing from the surviving chunks, not from the ones just freed
+    next_chunk_size_ = chunks_ != nullptr ? chunks_->size * 2 : first_chunk_size_;
+  }
+  begin_ = marker.begin_;
+  top_ = marker.top_;
+  end_ = marker.end_;
+  top_block_ = nullptr;
+  ++rewinds_;
+
+  auto below_marker = [&](const FreeBlock* block) {
+    auto address = reinterpret_cast<uintptr_t>(block);
+    if (address >= reinterpret_cast<uintptr_t>(marker.begin_) && address < reinterpret_cast<uintptr_t>(marker.end_)) {
+      return address < reinterpret_cast<uintptr_t>(marker.top_);
+    }
+    // Other buffers still held were filled before the marker's, freed chunks are gone
+    return contains(block);
+  };
+  for (FreeBlock*& head : free_lists_) {
+    FreeBlock** link = &head;
+    while (*link != nullptr) {
+      if (below_marker(*link)) {
+        link = &(*link)->next;
+      } else {
+        *link = (*link)->next;
+      }
+    }
+  }
+}
+
+// Scoped checkpoint: everything allocated from the storage during the guard's lifetime
+// is released at once when it is destroyed.
+class StackRegion {
+  StackStorageBase& storage_;
+  StackStorageBase::Marker marker_;
+
+public:
+  explicit StackRegion(StackStorageBase& storage): storage_(storage), marker_(storage.mark()) {
+    storage_.enter_region();
+  }
+
+  StackRegion(const StackRegion&) = delete;
+  StackRegion& operator=(const StackRegion&) = delete;
+
+  ~StackRegion() {
+    storage_.leave_region();
+    storage_.rewind(marker_);
+  }
+};
 
 template <size_t size>
-class StackStorage {
-private:  
-  char storage_[size];
-  size_t reserved_ = 0;
+class StackStorage : public StackStorageBase {
+private:
+  alignas(std::max_align_t) char storage_[size];
 
 public:
   StackStorage& operator=(const StackStorage&) = delete;
-  StackStorage() = default;
+  StackStorage(): StackStorageBase(storage_, size) {}
   StackStorage(const StackStorage& other) = delete;
-  char* get_array() { return storage_ + reserved_; }
-  void reserve(size_t n) { reserved_ += n; }
 };
 
+struct MappedStorageOptions {
+  bool huge_pages = false;        // back the mapping with MAP_HUGETLB, falling back to MADV_HUGEPAGE
+  bool prefault = false;          // populate all pages up front with MAP_POPULATE
+  bool decommit_on_reset = true;  // give pages back to the kernel with MADV_DONTNEED in reset()
+};
+
+// Storage of a size chosen at runtime, backed by an anonymous mmap instead of a static array
+class MappedStackStorage : public StackStorageBase {
+  size_t mapped_size_;
+  MappedStorageOptions options_;
+  Marker origin_;
+
+  static constexpr size_t kHugePageSize = 2 << 20;
+
+  static size_t mapping_size(size_t size, const MappedStorageOptions& options) {
+    return options.huge_pages ? (size + kHugePageSize - 1) & ~(kHugePageSize - 1) : size;
+  }
+
+  static char* map(size_t size, const MappedStorageOptions& options);
+
+public:
+  explicit MappedStackStorage(size_t size, MappedStorageOptions options = MappedStorageOptions())
+      : StackStorageBase(map(size, options), size), mapped_size_(mapping_size(size, options)),
+        options_(options), origin_(mark()) {}
+
+  MappedStackStorage(const MappedStackStorage&) = delete;
+  MappedStackStorage& operator=(const MappedStackStorage&) = delete;
+
+  ~MappedStackStorage() override { munmap(initial_buffer(), mapped_size_); }
+
+  // Releases everything allocated from the storage
+  void reset();
+};
+
+inline char* MappedStackStorage::map(size_t size, const MappedStorageOptions& options) {
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | (options.prefault ? MAP_POPULATE : 0);
+  size = mapping_size(size, options);
+  void* buffer = MAP_FAILED;
+
+  if (options.huge_pages) {
+    buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+    if (buffer != MAP_FAILED) {
+      return static_cast<char*>(buffer);
+    }
+  }
+
+  // No reserved huge pages: ask for transparent ones instead
+  buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, flags, -1, 0);
+  if (buffer == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  if (options.huge_pages) {
+    madvise(buffer, size, MADV_HUGEPAGE);
+  }
+  return static_cast<char*>(buffer);
+}
+
+inline void MappedStackStorage::reset() {
+  rewind(origin_);
+  if (options_.decommit_on_reset) {
+    madvise(initial_buffer(), mapped_size_, MADV_DONTNEED);
+  }
+}
+
+// Thread-local sub-arena carved from a shared storage in chunks of at least `chunk_size`
+// bytes. Allocations from the shard use no atomics; only refills touch the shared cursor.
+// Chunks are cache-line aligned and padded, so shards of different threads never share a line.
+class alignas(64) StackShard : public StackStorageBase {
+  StackStorageBase& parent_;
+  size_t chunk_size_;
+
+public:
+  static constexpr size_t kCacheLine = 64;
+
+  StackShard(StackStorageBase& parent, size_t chunk_size)
+      : StackStorageBase(nullptr, 0), parent_(parent), chunk_size_(chunk_size) {}
+
+  bool contains(const void* pointer) const override { return parent_.contains(pointer); }
+
+protected:
+  bool refill(size_t bytes, size_t alignment) override {
+    size_t chunk = std::max(chunk_size_, bytes + alignment);
+    chunk = (chunk + kCacheLine - 1) & ~(kCacheLine - 1);
+    void* buffer = parent_.try_allocate_concurrent(chunk, kCacheLine);
+    if (buffer == nullptr) {
+      return false;
+    }
+    reset_buffer(static_cast<char*>(buffer), chunk);
+    return true;
+  }
+};
+
+// `size` is kept in the type for compatibility; all allocators bound to one storage
+// share its whole capacity.
 template <typename T, size_t size>
 class StackAllocator {
 
-  void* current_storage_pos_;
-  void** ptr_to_storage_;
-  size_t sz_;
+  StackStorageBase* storage_;
 
 public:
 
@@ -27,6 +626,10 @@ public:
   using pointer_type = T*;
   using size_type = size_t;
 
+  // Memory from allocate(n) may be given back in smaller pieces, so containers
+  // can take the nodes of a whole range from one block
+  using splits_bulk_allocations = std::true_type;
+
   template <typename U>
   struct rebind {
     using other = StackAllocator<U, size>;
@@ -34,52 +637,822 @@ public:
 
   StackAllocator() = delete;
 
-  template <size_t N>
-  StackAllocator(StackStorage<N>& storage);
-  
+  StackAllocator(StackStorageBase& storage): storage_(&storage) {}
+
   template <typename U>
   StackAllocator(const StackAllocator<U, size>&);
 
   T* allocate(size_t n);
   void deallocate(T* pointer, size_t n);
-  bool operator==(const StackAllocator<T, size>& alloc) { return ptr_to_storage_ == alloc.get_ptr_to_storage(); }
+  // Releases `count` single objects linked through their first word, see StackStorageBase
+  void deallocate_chain(T* first, T* last, size_t count) {
+    storage_->deallocate_chain(first, last, count, sizeof(T));
+  }
+  // Grows an allocation of `n` objects to `new_n` without moving it, see StackStorageBase
+  bool try_expand(T* pointer, size_t n, size_t new_n) {
+    return storage_->try_expand(pointer, n * sizeof(T), new_n * sizeof(T));
+  }
 
-  void* get_storage() const { return current_storage_pos_; }
-  void** get_ptr_to_storage() const { return ptr_to_storage_; }
-  size_t get_size() const { return sz_; }
-};
+  template <typename U>
+  bool operator==(const StackAllocator<U, size>& alloc) const { return storage_ == alloc.get_storage(); }
 
-template <typename T, size_t size>
-template <size_t U>
-StackAllocator<T, size>::StackAllocator(StackStorage<U>& storage)
-                       : current_storage_pos_(storage.get_array())
-                       , ptr_to_storage_(&current_storage_pos_)
-                       , sz_(size) {
-  storage.reserve(size);
-}
+  StackStorageBase* get_storage() const { return storage_; }
+  bool in_scoped_region() const { return storage_->in_scoped_region(); }
+  size_t region_depth() const { return storage_->region_depth(); }
+  size_t rewind_count() const { return storage_->rewind_count(); }
+
+#ifdef STACK_ALLOCATOR_STATS
+  const StackStorageStatistics& statistics() const { return storage_->statistics(); }
+#endif
+};
 
 template <typename T, size_t size>
 template <typename U>
 StackAllocator<T, size>::StackAllocator(const StackAllocator<U, size>& alloc)
-                       : current_storage_pos_(alloc.get_storage())
-                       , ptr_to_storage_(alloc.get_ptr_to_storage())
-                       , sz_(alloc.get_size())
+                       : storage_(alloc.get_storage())
 {}
 
 template <typename T, size_t size>
 T* StackAllocator<T, size>::allocate(size_t n) {
-  if (std::align(alignof(T), n * sizeof(T), *ptr_to_storage_, sz_) != nullptr) {
-    T* result = reinterpret_cast<T*>(*ptr_to_storage_);
-    *ptr_to_storage_ = reinterpret_cast<char*>(*ptr_to_storage_) + sizeof(T) * n;
-    sz_ -= sizeof(T) * n;
-    return result;
-  }
-
-  throw std::bad_alloc();
+  return static_cast<T*>(storage_->allocate(n * sizeof(T), alignof(T)));
 }
 
 template <typename T, size_t size>
 void StackAllocator<T, size>::deallocate(T* pointer, size_t n) {
-  std::ignore = pointer;
-  std::ignore = n;
+  storage_->deallocate(pointer, n * sizeof(T));
+}
+
+// Same as StackAllocator, but safe to use from several threads sharing one storage
+template <typename T, size_t size>
+class ConcurrentStackAllocator {
+
+  StackStorageBase* storage_;
+
+public:
+
+  using value_type = T;
+  using pointer_type = T*;
+  using size_type = size_t;
+
+  using splits_bulk_allocations = std::true_type; // see StackAllocator
+
+  template <typename U>
+  struct rebind {
+    using other = ConcurrentStackAllocator<U, size>;
+  };
+
+  ConcurrentStackAllocator() = delete;
+
+  ConcurrentStackAllocator(StackStorageBase& storage): storage_(&storage) {}
+
+  template <typename U>
+  ConcurrentStackAllocator(const ConcurrentStackAllocator<U, size>& alloc): storage_(alloc.get_storage()) {}
+
+  T* allocate(size_t n) {
+    return static_cast<T*>(storage_->allocate_concurrent(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t n) {
+    storage_->deallocate_concurrent(pointer, n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const ConcurrentStackAllocator<U, size>& alloc) const { return storage_ == alloc.get_storage(); }
+
+  StackStorageBase* get_storage() const { return storage_; }
+};
+
+// Pool of equally sized blocks. Slabs come from `upstream` (or the heap when it is null)
+// and are sliced lazily; released blocks go to an intrusive free list, so both
+// allocation and release are a couple of pointer moves without alignment arithmetic.
+class NodePool {
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  // Header of a heap slab, followed by its blocks
+  struct alignas(std::max_align_t) Slab {
+    Slab* previous;
+  };
+
+  size_t block_size_;
+  size_t alignment_;
+  size_t slab_size_;
+  StackStorageBase* upstream_;
+  FreeBlock* free_;
+  char* slab_top_; // unsliced part of the current slab
+  char* slab_end_;
+  Slab* heap_slabs_;
+
+  void* allocate_from_new_slab();
+
+public:
+  static constexpr size_t kSlabSize = 64 << 10;
+
+  NodePool(size_t size, size_t alignment, StackStorageBase* upstream)
+      : block_size_(0), alignment_(std::max(alignment, alignof(FreeBlock))), slab_size_(0), upstream_(upstream),
+        free_(nullptr), slab_top_(nullptr), slab_end_(nullptr), heap_slabs_(nullptr) {
+    block_size_ = (std::max(size, sizeof(FreeBlock)) + alignment_ - 1) & ~(alignment_ - 1);
+    slab_size_ = std::max(kSlabSize / block_size_, size_t(1)) * block_size_;
+  }
+
+  NodePool(const NodePool&) = delete;
+  NodePool& operator=(const NodePool&) = delete;
+
+  // Heap slabs are freed; slabs taken from a storage stay there until it is rewound
+  ~NodePool();
+
+  void* allocate() {
+    if (free_ != nullptr) {
+      FreeBlock* block = free_;
+      free_ = block->next;
+      return block;
+    }
+    if (slab_top_ != slab_end_) {
+      void* block = slab_top_;
+      slab_top_ += block_size_;
+      return block;
+    }
+    return allocate_from_new_slab();
+  }
+
+  void deallocate(void* pointer) {
+    free_ = ::new (pointer) FreeBlock{free_};
+  }
+
+  size_t block_size() const { return block_size_; }
+  size_t alignment() const { return alignment_; }
+};
+
+inline void* NodePool::allocate_from_new_slab() {
+  if (upstream_ != nullptr) {
+    slab_top_ = static_cast<char*>(upstream_->allocate(slab_size_, alignment_));
+  } else {
+    size_t header = (sizeof(Slab) + alignment_ - 1) & ~(alignment_ - 1);
+    auto* slab = static_cast<Slab*>(::operator new(header + slab_size_, std::align_val_t(alignment_)));
+    slab->previous = heap_slabs_;
+    heap_slabs_ = slab;
+    slab_top_ = reinterpret_cast<char*>(slab) + header;
+  }
+  slab_end_ = slab_top_ + slab_size_;
+
+  void* block = slab_top_;
+  slab_top_ += block_size_;
+  return block;
+}
+
+inline NodePool::~NodePool() {
+  while (heap_slabs_ != nullptr) {
+    Slab* previous = heap_slabs_->previous;
+    ::operator delete(heap_slabs_, std::align_val_t(alignment_));
+    heap_slabs_ = previous;
+  }
+}
+
+// Pools of one PoolAllocator family, one per block size and alignment, so that rebound
+// copies of an allocator share memory and compare equal
+class NodePoolGroup {
+  StackStorageBase* upstream_;
+  std::vector<std::unique_ptr<NodePool>> pools_;
+
+public:
+  explicit NodePoolGroup(StackStorageBase* upstream): upstream_(upstream), pools_() {}
+
+  NodePoolGroup(const NodePoolGroup&) = delete;
+  NodePoolGroup& operator=(const NodePoolGroup&) = delete;
+
+  NodePool& get_pool(size_t size, size_t alignment);
+  StackStorageBase* get_upstream() const { return upstream_; }
+};
+
+inline NodePool& NodePoolGroup::get_pool(size_t size, size_t alignment) {
+  NodePool candidate(size, alignment, upstream_);
+  for (auto& pool : pools_) {
+    if (pool->block_size() == candidate.block_size() && pool->alignment() == candidate.alignment()) {
+      return *pool;
+    }
+  }
+  pools_.push_back(std::make_unique<NodePool>(size, alignment, upstream_));
+  return *pools_.back();
+}
+
+// Allocator for node-based containers: single objects come from a NodePool sized for T,
+// anything else goes straight to the upstream storage (or the heap).
+template <typename T>
+class PoolAllocator {
+
+  std::shared_ptr<NodePoolGroup> group_;
+  NodePool* pool_;
+
+public:
+
+  using value_type = T;
+  using pointer_type = T*;
+  using size_type = size_t;
+
+  template <typename U>
+  struct rebind {
+    using other = PoolAllocator<U>;
+  };
+
+  PoolAllocator(): PoolAllocator(nullptr) {}
+
+  PoolAllocator(StackStorageBase& storage): PoolAllocator(&storage) {}
+
+  explicit PoolAllocator(StackStorageBase* upstream)
+      : group_(std::make_shared<NodePoolGroup>(upstream)), pool_(&group_->get_pool(sizeof(T), alignof(T))) {}
+
+  PoolAllocator(const PoolAllocator&) = default;
+  PoolAllocator& operator=(const PoolAllocator&) = default;
+
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U>& alloc)
+      : group_(alloc.get_group()), pool_(&group_->get_pool(sizeof(T), alignof(T))) {}
+
+  T* allocate(size_t n);
+  void deallocate(T* pointer, size_t n);
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U>& alloc) const { return group_ == alloc.get_group(); }
+
+  const std::shared_ptr<NodePoolGroup>& get_group() const { return group_; }
+};
+
+template <typename T>
+T* PoolAllocator<T>::allocate(size_t n) {
+  if (n == 1) {
+    return static_cast<T*>(pool_->allocate());
+  }
+  if (StackStorageBase* upstream = group_->get_upstream()) {
+    return static_cast<T*>(upstream->allocate(n * sizeof(T), alignof(T)));
+  }
+  return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+}
+
+template <typename T>
+void PoolAllocator<T>::deallocate(T* pointer, size_t n) {
+  if (n == 1) {
+    pool_->deallocate(pointer);
+  } else if (StackStorageBase* upstream = group_->get_upstream()) {
+    upstream->deallocate(pointer, n * sizeof(T));
+  } else {
+    ::operator delete(pointer, std::align_val_t(alignof(T)));
+  }
+}
+
+// std::pmr adapter: lets pmr containers and polymorphic_allocator share one storage.
+// Requests the storage cannot satisfy go to `upstream` (null_memory_resource() by default,
+// which throws std::bad_alloc).
+class StackMemoryResource : public std::pmr::memory_resource {
+public:
+  struct Statistics {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_in_use = 0;
+    size_t upstream_allocations = 0;
+    size_t upstream_bytes_in_use = 0;
+  };
+
+  explicit StackMemoryResource(StackStorageBase& storage,
+                               std::pmr::memory_resource* upstream = std::pmr::null_memory_resource())
+      : storage_(&storage), upstream_(upstream), statistics_() {}
+
+  StackMemoryResource(const StackMemoryResource&) = delete;
+  StackMemoryResource& operator=(const StackMemoryResource&) = delete;
+
+  StackStorageBase* get_storage() const { return storage_; }
+  std::pmr::memory_resource* upstream_resource() const { return upstream_; }
+  const Statistics& statistics() const { return statistics_; }
+
+private:
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  StackStorageBase* storage_;
+  std::pmr::memory_resource* upstream_;
+  Statistics statistics_;
+};
+
+inline void* StackMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+  void* block = storage_->try_allocate(bytes, alignment);
+  if (block == nullptr) {
+    block = upstream_->allocate(bytes, alignment);
+    ++statistics_.upstream_allocations;
+    statistics_.upstream_bytes_in_use += bytes;
+  }
+  ++statistics_.allocations;
+  statistics_.bytes_in_use += bytes;
+  return block;
+}
+
+inline void StackMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+  ++statistics_.deallocations;
+  statistics_.bytes_in_use -= bytes;
+
+  // Ownership only has to be checked once anything went upstream
+  if (statistics_.upstream_bytes_in_use == 0 || storage_->contains(pointer)) {
+    storage_->deallocate(pointer, bytes);
+    return;
+  }
+  statistics_.upstream_bytes_in_use -= bytes;
+  upstream_->deallocate(pointer, bytes, alignment);
+}
+
+// Pointer that stores the distance from itself to its target instead of an address, so
+// a structure linked through OffsetPtr stays valid when its memory is copied or mapped
+// at another address. Meant to be an allocator's `pointer`, see OffsetAllocator.
+template <typename T>
+class OffsetPtr {
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = std::add_lvalue_reference_t<T>;
+  using iterator_category = std::random_access_iterator_tag;
+
+  OffsetPtr() = default;
+  OffsetPtr(std::nullptr_t) {}
+  OffsetPtr(T* pointer) { set(pointer); }
+  OffsetPtr(const OffsetPtr& other) { set(other.get()); }
+
+  template <typename U>
+    requires std::is_convertible_v<U*, T*>
+  OffsetPtr(const OffsetPtr<U>& other) { set(other.get()); }
+
+  // Downcasts and casts from void, as static_cast does for raw pointers
+  template <typename U>
+    requires (!std::is_convertible_v<U*, T*>) && requires(U* other) { static_cast<T*>(other); }
+  explicit OffsetPtr(const OffsetPtr<U>& other) { set(static_cast<T*>(other.get())); }
+
+  OffsetPtr& operator=(const OffsetPtr& other) {
+    set(other.get());
+    return *this;
+  }
+
+  template <typename U = T>
+    requires (!std::is_void_v<U>)
+  static OffsetPtr pointer_to(U& object) { return OffsetPtr(std::addressof(object)); }
+
+  T* get() const {
+    if (offset_ == kNull) {
+      return nullptr;
+    }
+    return reinterpret_cast<T*>(reinterpret_cast<uintptr_t>(this) + offset_);
+  }
+
+  reference operator*() const { return *get(); }
+  T* operator->() const { return get(); }
+  explicit operator bool() const { return offset_ != kNull; }
+
+  OffsetPtr& operator+=(difference_type n) {
+    set(get() + n);
+    return *this;
+  }
+  OffsetPtr& operator-=(difference_type n) { return *this += -n; }
+  OffsetPtr& operator++() { return *this += 1; }
+  OffsetPtr& operator--() { return *this -= 1; }
+
+  OffsetPtr operator++(int) {
+    OffsetPtr copy = *this;
+    ++*this;
+    return copy;
+  }
+
+  OffsetPtr operator--(int) {
+    OffsetPtr copy = *this;
+    --*this;
+    return copy;
+  }
+
+  friend OffsetPtr operator+(OffsetPtr pointer, difference_type n) { return pointer += n; }
+  friend OffsetPtr operator-(OffsetPtr pointer, difference_type n) { return pointer -= n; }
+  friend difference_type operator-(const OffsetPtr& lhs, const OffsetPtr& rhs) { return lhs.get() - rhs.get(); }
+
+  friend bool operator==(const OffsetPtr& lhs, const OffsetPtr& rhs) { return lhs.get() == rhs.get(); }
+  friend std::strong_ordering operator<=>(const OffsetPtr& lhs, const OffsetPtr& rhs) {
+    return std::compare_three_way()(lhs.get(), rhs.get());
+  }
+
+private:
+  // An offset of one would point into the OffsetPtr itself, so it can stand for null
+  static constexpr std::ptrdiff_t kNull = 1;
+
+  void set(T* pointer) {
+    offset_ = pointer == nullptr ? kNull
+                                 : reinterpret_cast<uintptr_t>(pointer) - reinterpret_cast<uintptr_t>(this);
+  }
+
+  std::ptrdiff_t offset_ = kNull;
+};
+
+enum class SnapshotMode { ReadOnly, CopyOnWrite };
+
+template <SnapshotMode mode>
+class BasicStackStorageSnapshot;
+
+// Bump-pointer storage keeping all of its state in a header at the start of the buffer it
+// manages, as offsets: a byte copy of the buffer, or the same buffer mapped elsewhere, is
+// the same storage. The cursor is atomic, so several threads may allocate at once.
+// Memory is only reclaimed when the most recent block is given back.
+class RelocatableStackStorage {
+  template <SnapshotMode mode>
+  friend class BasicStackStorageSnapshot;
+
+public:
+  // Formats `size` bytes at `buffer`, which must be aligned at least as strictly as
+  // anything allocated from it
+  static RelocatableStackStorage& create(void* buffer, size_t size);
+  // Storage formatted earlier, possibly at another address
+  static RelocatableStackStorage& attach(void* buffer);
+
+  RelocatableStackStorage(const RelocatableStackStorage&) = delete;
+  RelocatableStackStorage& operator=(const RelocatableStackStorage&) = delete;
+
+  void* allocate(size_t bytes, size_t alignment);
+  void deallocate(void* pointer, size_t bytes);
+
+  size_t size() const { return size_; }
+  // Bytes from the start of the buffer up to the cursor, i.e. what a copy has to take
+  size_t used() const { return top_.load(std::memory_order_acquire); }
+
+  // Objects the contents are reached from after the buffer has moved, looked up by name.
+  // set_root() with a null object removes the entry. Roots are not synchronized, set them
+  // before anyone else attaches.
+  static constexpr size_t kMaxRoots = 16;
+  static constexpr size_t kMaxRootName = 31;
+
+  void* root(std::string_view name = "") const;
+  void set_root(void* object) { set_root("", object); }
+  void set_root(std::string_view name, void* object);
+
+  // Writes the used part of the buffer to `path`, to be mapped back by StackStorageSnapshot.
+  // Nobody may allocate meanwhile.
+  void save(const std::string& path) const;
+
+private:
+  struct Root {
+    char name[kMaxRootName + 1] = {};
+    OffsetPtr<void> object = nullptr;
+  };
+
+  explicit RelocatableStackStorage(size_t size)
+      : magic_(0), size_(size), top_(sizeof(RelocatableStackStorage)), roots_() {}
+
+  const Root* find_root(std::string_view name) const;
+
+  // attach() checks the header against the layout this build expects. The magic is
+  // written last, so another process never sees a half-formatted header.
+  static constexpr uint64_t kMagic = 0x524c4f4353544b31; // "RLOCSTK1"
+  static constexpr uint32_t kVersion = 2;
+
+  std::atomic<uint64_t> magic_;
+  uint32_t version_ = kVersion;
+  uint32_t header_size_ = sizeof(RelocatableStackStorage);
+  uint64_t size_;
+  std::atomic<uint64_t> top_; // offset of the first free byte
+  Root roots_[kMaxRoots];      // an entry is free while its object is null
+};
+
+// Processes share the cursor through memory, which only works for lock-free atomics
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+inline RelocatableStackStorage& RelocatableStackStorage::create(void* buffer, size_t size) {
+  if (size < sizeof(RelocatableStackStorage)) {
+    throw std::bad_alloc();
+  }
+  auto* storage = ::new (buffer) RelocatableStackStorage(size);
+  storage->magic_.store(kMagic, std::memory_order_release);
+  return *storage;
+}
+
+inline RelocatableStackStorage& RelocatableStackStorage::attach(void* buffer) {
+  auto* storage = std::launder(static_cast<RelocatableStackStorage*>(buffer));
+  if (storage->magic_.load(std::memory_order_acquire) != kMagic) {
+    throw std::invalid_argument("buffer does not hold a RelocatableStackStorage");
+  }
+  if (storage->version_ != kVersion || storage->header_size_ != sizeof(RelocatableStackStorage)) {
+    throw std::invalid_argument("RelocatableStackStorage was written with another layout");
+  }
+  return *storage;
+}
+
+inline void* RelocatableStackStorage::allocate(size_t bytes, size_t alignment) {
+  uintptr_t base = reinterpret_cast<uintptr_t>(this);
+  uint64_t top = top_.load(std::memory_order_relaxed);
+  uint64_t begin = 0;
+  do {
+    begin = ((base + top + alignment - 1) & ~(alignment - 1)) - base;
+    if (begin + bytes > size_) [[unlikely]] {
+      throw std::bad_alloc();
+    }
+  } while (!top_.compare_exchange_weak(top, begin + bytes, std::memory_order_relaxed));
+  return reinterpret_cast<char*>(this) + begin;
+}
+
+inline void RelocatableStackStorage::deallocate(void* pointer, size_t bytes) {
+  uint64_t begin = static_cast<char*>(pointer) - reinterpret_cast<char*>(this);
+  uint64_t end = begin + bytes;
+  top_.compare_exchange_strong(end, begin, std::memory_order_relaxed);
+}
+
+inline auto RelocatableStackStorage::find_root(std::string_view name) const -> const Root* {
+  for (const Root& root : roots_) {
+    if (root.object && name == root.name) {
+      return &root;
+    }
+  }
+  return nullptr;
+}
+
+inline void* RelocatableStackStorage::root(std::string_view name) const {
+  const Root* root = find_root(name);
+  return root != nullptr ? root->object.get() : nullptr;
+}
+
+inline void RelocatableStackStorage::set_root(std::string_view name, void* object) {
+  if (name.size() > kMaxRootName) {
+    throw std::length_error("root name is too long");
+  }
+  Root* root = const_cast<Root*>(find_root(name));
+  if (root == nullptr) {
+    if (object == nullptr) {
+      return;
+    }
+    root = std::find_if(std::begin(roots_), std::end(roots_), [](const Root& entry) { return !entry.object; });
+    if (root == std::end(roots_)) {
+      throw std::length_error("root table is full");
+    }
+    std::memset(root->name, 0, sizeof(root->name));
+    name.copy(root->name, name.size());
+  }
+  root->object = object;
+}
+
+inline void RelocatableStackStorage::save(const std::string& path) const {
+  int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(), "open");
+  }
+  const char* data = reinterpret_cast<const char*>(this);
+  size_t left = used();
+  while (left != 0) {
+    ssize_t written = write(fd, data, left);
+    if (written == -1 && errno == EINTR) {
+      continue;
+    }
+    if (written == -1) {
+      int error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "write");
+    }
+    data += written;
+    left -= static_cast<size_t>(written);
+  }
+  if (close(fd) == -1) {
+    throw std::system_error(errno, std::generic_category(), "close");
+  }
+}
+
+// Allocator handing out OffsetPtr from a RelocatableStackStorage. It refers to the storage
+// through an OffsetPtr too, so a container constructed inside the storage's buffer keeps
+// working after the buffer is copied or mapped at another address.
+template <typename T>
+class OffsetAllocator {
+
+  OffsetPtr<RelocatableStackStorage> storage_;
+
+public:
+
+  using value_type = T;
+  using pointer = OffsetPtr<T>;
+  using const_pointer = OffsetPtr<const T>;
+  using void_pointer = OffsetPtr<void>;
+  using const_void_pointer = OffsetPtr<const void>;
+  using size_type = size_t;
+
+  using splits_bulk_allocations = std::true_type; // see StackAllocator
+
+  template <typename U>
+  struct rebind {
+    using other = OffsetAllocator<U>;
+  };
+
+  OffsetAllocator() = delete;
+
+  OffsetAllocator(RelocatableStackStorage& storage): storage_(&storage) {}
+
+  template <typename U>
+  OffsetAllocator(const OffsetAllocator<U>& alloc): storage_(alloc.get_storage()) {}
+
+  pointer allocate(size_t n) {
+    return static_cast<T*>(storage_->allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(pointer block, size_t n) {
+    storage_->deallocate(block.get(), n * sizeof(T));
+  }
+
+  template <typename U>
+  bool operator==(const OffsetAllocator<U>& alloc) const { return get_storage() == alloc.get_storage(); }
+
+  RelocatableStackStorage* get_storage() const { return storage_.get(); }
+};
+
+// RelocatableStackStorage in a POSIX shared memory object: every process mapping the same
+// name works with one storage, wherever its mapping lands. Constructed with a size, it
+// creates and formats the object, which must not exist yet; with the name alone it
+// attaches to one created before. The destructor unmaps, only unlink() removes the object.
+class SharedStackStorage {
+  char* buffer_;
+  size_t size_;
+  RelocatableStackStorage* storage_;
+
+  [[noreturn]] static void throw_errno(const char* call) {
+    throw std::system_error(errno, std::generic_category(), call);
+  }
+
+  // Maps the whole object and closes `fd`
+  static char* map(int fd, size_t size);
+
+public:
+  SharedStackStorage(const std::string& name, size_t size);
+  explicit SharedStackStorage(const std::string& name);
+
+  SharedStackStorage(const SharedStackStorage&) = delete;
+  SharedStackStorage& operator=(const SharedStackStorage&) = delete;
+
+  ~SharedStackStorage() { munmap(buffer_, size_); }
+
+  RelocatableStackStorage& storage() const { return *storage_; }
+  void* data() const { return buffer_; }
+  size_t size() const { return size_; }
+
+  static void unlink(const std::string& name) { shm_unlink(name.c_str()); }
+};
+
+inline char* SharedStackStorage::map(int fd, size_t size) {
+  void* buffer = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  int error = errno;
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), "mmap");
+  }
+  return static_cast<char*>(buffer);
+}
+
+inline SharedStackStorage::SharedStackStorage(const std::string& name, size_t size)
+    : buffer_(nullptr), size_(size), storage_(nullptr) {
+  if (size < sizeof(RelocatableStackStorage)) {
+    throw std::bad_alloc();
+  }
+  int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd == -1) {
+    throw_errno("shm_open");
+  }
+  if (ftruncate(fd, static_cast<off_t>(size)) == -1) {
+    int error = errno;
+    close(fd);
+    shm_unlink(name.c_str());
+    throw std::system_error(error, std::generic_category(), "ftruncate");
+  }
+  try {
+    buffer_ = map(fd, size);
+  } catch(...) {
+    shm_unlink(name.c_str());
+    throw;
+  }
+  storage_ = &RelocatableStackStorage::create(buffer_, size);
+}
+
+inline SharedStackStorage::SharedStackStorage(const std::string& name)
+    : buffer_(nullptr), size_(0), storage_(nullptr) {
+  int fd = shm_open(name.c_str(), O_RDWR, 0);
+  if (fd == -1) {
+    throw_errno("shm_open");
+  }
+  struct stat info {};
+  if (fstat(fd, &info) == -1) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "fstat");
+  }
+  if (static_cast<size_t>(info.st_size) < sizeof(RelocatableStackStorage)) {
+    close(fd);
+    throw std::invalid_argument("shared memory object " + name + " is not formatted yet");
+  }
+
+  size_ = static_cast<size_t>(info.st_size);
+  buffer_ = map(fd, size_);
+  try {
+    storage_ = &RelocatableStackStorage::attach(buffer_);
+    if (storage_->size() != size_) {
+      throw std::invalid_argument("shared memory object " + name + " was resized");
+    }
+  } catch(...) {
+    munmap(buffer_, size_);
+    throw;
+  }
+}
+
+// Storage saved by RelocatableStackStorage::save(), mapped back from the file: pages are
+// read in on first touch, so start-up costs page faults instead of rebuilding the contents.
+// A read-only snapshot is mapped PROT_READ and only hands out const access to the storage
+// and its roots. A copy-on-write one may be modified, changes stay private to the mapping,
+// and `headroom` bytes past the saved contents are free to allocate.
+template <SnapshotMode mode>
+class BasicStackStorageSnapshot {
+  static constexpr bool kWritable = mode == SnapshotMode::CopyOnWrite;
+
+public:
+  using storage_type = std::conditional_t<kWritable, RelocatableStackStorage, const RelocatableStackStorage>;
+
+  explicit BasicStackStorageSnapshot(const std::string& path) requires (!kWritable)
+      : buffer_(nullptr), size_(0), storage_(nullptr) { map(path, 0); }
+  explicit BasicStackStorageSnapshot(const std::string& path, size_t headroom = 0) requires kWritable
+      : buffer_(nullptr), size_(0), storage_(nullptr) { map(path, headroom); }
+
+  BasicStackStorageSnapshot(const BasicStackStorageSnapshot&) = delete;
+  BasicStackStorageSnapshot& operator=(const BasicStackStorageSnapshot&) = delete;
+
+  ~BasicStackStorageSnapshot() { munmap(buffer_, size_); }
+
+  storage_type& storage() const { return *storage_; }
+
+  // Root object saved under `name`, null if there is none
+  template <typename T>
+  auto root(std::string_view name = "") const {
+    using object_type = std::conditional_t<kWritable, T, const T>;
+    return static_cast<object_type*>(storage_->root(name));
+  }
+
+private:
+  void map(const std::string& path, size_t headroom);
+
+  char* buffer_;
+  size_t size_;
+  storage_type* storage_;
+};
+
+using StackStorageSnapshot = BasicStackStorageSnapshot<SnapshotMode::ReadOnly>;
+using CopyOnWriteStackStorageSnapshot = BasicStackStorageSnapshot<SnapshotMode::CopyOnWrite>;
+
+template <SnapshotMode mode>
+void BasicStackStorageSnapshot<mode>::map(const std::string& path, size_t headroom) {
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::system_error(errno, std::generic_category(), "open");
+  }
+  struct stat info {};
+  if (fstat(fd, &info) == -1) {
+    int error = errno;
+    close(fd);
+    throw std::system_error(error, std::generic_category(), "fstat");
+  }
+  size_t file_size = static_cast<size_t>(info.st_size);
+  if (file_size < sizeof(RelocatableStackStorage)) {
+    close(fd);
+    throw std::invalid_argument(path + " is not a storage snapshot");
+  }
+
+  void* buffer = MAP_FAILED;
+  if constexpr (!kWritable) {
+    size_ = file_size;
+    buffer = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  } else {
+    // The file goes over the start of an anonymous mapping that provides the headroom
+    size_ = file_size + headroom;
+    buffer = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer != MAP_FAILED
+        && mmap(buffer, file_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+      int error = errno;
+      munmap(buffer, size_);
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "mmap");
+    }
+  }
+  int error = errno;
+  close(fd);
+  if (buffer == MAP_FAILED) {
+    throw std::system_error(error, std::generic_category(), "mmap");
+  }
+
+  buffer_ = static_cast<char*>(buffer);
+  try {
+    storage_ = &RelocatableStackStorage::attach(buffer_);
+  } catch(...) {
+    munmap(buffer_, size_);
+    throw;
+  }
+  if (storage_->used() != file_size) {
+    munmap(buffer_, size_);
+    throw std::invalid_argument(path + " is truncated");
+  }
+  if constexpr (kWritable) {
+    storage_->size_ = size_;
+  }
 }
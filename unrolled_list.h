@@ -0,0 +1,468 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// About 256 bytes of elements per node for small types
+template <typename T>
+inline constexpr size_t kUnrolledNodeCapacity = sizeof(T) < 64 ? 256 / sizeof(T) : 4;
+
+// Doubly linked list of small arrays: every node stores up to K elements contiguously, so
+// small elements do not pay for two link pointers each and neighbours share cache lines.
+// Full nodes are split on insertion, sparse neighbours are merged on erasure.
+//
+// Unlike list, insert and erase invalidate iterators into the nodes they touch (including
+// a node split off or merged in), so use the iterators they return. Elements are moved
+// between slots, which is why T must be nothrow move constructible.
+template <typename T, typename Alloc = std::allocator<T>, size_t K = kUnrolledNodeCapacity<T>>
+class unrolled_list {
+  static_assert(K >= 2, "A node must hold at least two elements");
+  static_assert(std::is_nothrow_move_constructible_v<T>, "Elements are relocated between slots");
+
+  struct BaseNode {
+    BaseNode* next;
+    BaseNode* prev;
+
+    BaseNode() = default;
+    BaseNode(BaseNode* next, BaseNode* prev): next(next), prev(prev) {}
+  };
+
+  struct Node : BaseNode {
+    size_t count;
+    alignas(T) unsigned char storage[K * sizeof(T)];
+
+    Node(BaseNode* next, BaseNode* prev): BaseNode(next, prev), count(0) {}
+
+    T* slot(size_t index) { return reinterpret_cast<T*>(storage) + index; }
+  };
+
+  template <bool isConst>
+  class base_iterator {
+  public:
+    using reference_type = std::conditional_t<isConst, const T&, T&>;
+    using pointer_type = std::conditional_t<isConst, const T*, T*>;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+  private:
+
+    BaseNode* node;
+    size_t index;
+    base_iterator(BaseNode* node, size_t index): node(node), index(index) {}
+    base_iterator(const BaseNode* node, size_t index): node(const_cast<BaseNode*>(node)), index(index) {}
+
+    friend class unrolled_list<T, Alloc, K>;
+  public:
+    base_iterator() = default;
+    base_iterator(const base_iterator&) = default;
+    base_iterator& operator=(const base_iterator&) = default;
+    bool operator==(const base_iterator&) const = default;
+
+    reference_type operator*() const { return *static_cast<Node*>(node)->slot(index); }
+    pointer_type operator->() const { return static_cast<Node*>(node)->slot(index); }
+
+    base_iterator& operator++() {
+      if (++index == static_cast<Node*>(node)->count) {
+        node = node->next;
+        index = 0;
+      }
+      return *this;
+    }
+
+    base_iterator operator++(int) {
+      base_iterator copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    base_iterator& operator--() {
+      if (index == 0) {
+        node = node->prev;
+        index = static_cast<Node*>(node)->count;
+      }
+      --index;
+      return *this;
+    }
+
+    base_iterator operator--(int) {
+      base_iterator copy = *this;
+      --*this;
+      return copy;
+    }
+
+    operator base_iterator<true>() const {
+      return {node, index};
+    }
+  };
+
+  using node_allocator = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+  using node_traits = std::allocator_traits<node_allocator>;
+
+  // Circular like list: fakeNode_.next is the first node, fakeNode_.prev the last one
+  BaseNode fakeNode_;
+  node_allocator alloc_;
+  size_t sz_;
+
+  // Allocates an empty node and links it before `pos`
+  Node* create_node(BaseNode* pos);
+  // Unlinks and frees a node whose elements are already destroyed
+  void destroy_node(Node* node);
+
+  // Moves elements [index, count) one slot up, leaving slot `index` unconstructed
+  static void shift_right(Node* node, size_t index);
+  // Destroys the element at `index` and moves the following ones one slot down
+  static void remove_at(Node* node, size_t index);
+  // Moves `count` elements starting at from->slot(first) to the end of `to`
+  static void relocate(Node* from, size_t first, size_t count, Node* to);
+
+  // Moves the upper half of a full node into a new node right after it
+  Node* split(Node* node);
+
+  void steal_nodes(unrolled_list& other);
+
+public:
+
+  using value_type = T;
+  using allocator_type = Alloc;
+
+  using iterator = base_iterator<false>;
+  using const_iterator = base_iterator<true>;
+  using reverse_iterator = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  iterator begin() { return { fakeNode_.next, 0 }; }
+  iterator end() { return { &fakeNode_, 0 }; }
+
+  const_iterator begin() const { return { fakeNode_.next, 0 }; }
+  const_iterator end() const { return { &fakeNode_, 0 }; }
+
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+
+  const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+  const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+  unrolled_list(): fakeNode_{ &fakeNode_, &fakeNode_ }, alloc_(node_allocator()), sz_(0) {}
+  explicit unrolled_list(const Alloc& allocator);
+  unrolled_list(size_t count, const T& value, const Alloc& allocator = Alloc());
+  unrolled_list(std::initializer_list<T> values, const Alloc& allocator = Alloc());
+  unrolled_list(const unrolled_list& other);
+  unrolled_list(unrolled_list&& other) noexcept;
+
+  ~unrolled_list();
+
+  unrolled_list& operator=(const unrolled_list& other);
+  unrolled_list& operator=(unrolled_list&& other)
+      noexcept(node_traits::propagate_on_container_move_assignment::value
+               || node_traits::is_always_equal::value);
+
+  void swap(unrolled_list& other);
+  void clear() noexcept;
+
+  void push_back(const T& elem) { emplace(end(), elem); }
+  void push_back(T&& elem) { emplace(end(), std::move(elem)); }
+  void push_front(const T& elem) { emplace(begin(), elem); }
+  void push_front(T&& elem) { emplace(begin(), std::move(elem)); }
+  void pop_back() { erase(std::prev(end())); }
+  void pop_front() { erase(begin()); }
+
+  template <typename... Args>
+  T& emplace_back(Args&&... args) { return *emplace(end(), std::forward<Args>(args)...); }
+  template <typename... Args>
+  T& emplace_front(Args&&... args) { return *emplace(begin(), std::forward<Args>(args)...); }
+
+  iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+  iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  iterator erase(const_iterator pos);
+
+  size_t size() const { return sz_; }
+  bool empty() const { return sz_ == 0; }
+  allocator_type get_allocator() const { return alloc_; }
+};
+
+template <typename T, typename Alloc, size_t K>
+auto unrolled_list<T, Alloc, K>::create_node(BaseNode* pos) -> Node* {
+  Node* node = node_traits::allocate(alloc_, 1);
+  node_traits::construct(alloc_, node, pos, pos->prev);
+  pos->prev->next = node;
+  pos->prev = node;
+  return node;
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::destroy_node(Node* node) {
+  node->prev->next = node->next;
+  node->next->prev = node->prev;
+  node_traits::destroy(alloc_, node);
+  node_traits::deallocate(alloc_, node, 1);
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::shift_right(Node* node, size_t index) {
+  size_t count = node->count;
+  if (index == count) {
+    return;
+  }
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    std::memmove(static_cast<void*>(node->slot(index + 1)), node->slot(index), (count - index) * sizeof(T));
+  } else {
+    std::construct_at(node->slot(count), std::move(*node->slot(count - 1)));
+    std::move_backward(node->slot(index), node->slot(count - 1), node->slot(count));
+    std::destroy_at(node->slot(index));
+  }
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::remove_at(Node* node, size_t index) {
+  size_t count = node->count;
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    std::memmove(static_cast<void*>(node->slot(index)), node->slot(index + 1), (count - index - 1) * sizeof(T));
+  } else {
+    std::move(node->slot(index + 1), node->slot(count), node->slot(index));
+    std::destroy_at(node->slot(count - 1));
+  }
+  --node->count;
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::relocate(Node* from, size_t first, size_t count, Node* to) {
+  if constexpr (std::is_trivially_copyable_v<T>) {
+    std::memcpy(static_cast<void*>(to->slot(to->count)), from->slot(first), count * sizeof(T));
+  } else {
+    std::uninitialized_move(from->slot(first), from->slot(first + count), to->slot(to->count));
+    std::destroy(from->slot(first), from->slot(first + count));
+  }
+  to->count += count;
+  from->count -= count;
+}
+
+template <typename T, typename Alloc, size_t K>
+auto unrolled_list<T, Alloc, K>::split(Node* node) -> Node* {
+  Node* upper = create_node(node->next);
+  size_t half = node->count / 2;
+  relocate(node, half, node->count - half, upper);
+  return upper;
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::steal_nodes(unrolled_list& other) {
+  if (other.sz_ == 0) {
+    return;
+  }
+
+  fakeNode_.next = other.fakeNode_.next;
+  fakeNode_.prev = other.fakeNode_.prev;
+  fakeNode_.next->prev = &fakeNode_;
+  fakeNode_.prev->next = &fakeNode_;
+  sz_ = other.sz_;
+
+  other.fakeNode_.next = &other.fakeNode_;
+  other.fakeNode_.prev = &other.fakeNode_;
+  other.sz_ = 0;
+}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::unrolled_list(const Alloc& allocator)
+    : fakeNode_{ &fakeNode_, &fakeNode_ },
+      alloc_(allocator),
+      sz_(0)
+{}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::unrolled_list(size_t count, const T& value, const Alloc& allocator)
+    : fakeNode_{ &fakeNode_, &fakeNode_ },
+      alloc_(allocator),
+      sz_(0) {
+  try {
+    for (size_t i = 0; i < count; ++i) {
+      push_back(value);
+    }
+  } catch(...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::unrolled_list(std::initializer_list<T> values, const Alloc& allocator)
+    : fakeNode_{ &fakeNode_, &fakeNode_ },
+      alloc_(allocator),
+      sz_(0) {
+  try {
+    for (const T& value : values) {
+      push_back(value);
+    }
+  } catch(...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::unrolled_list(const unrolled_list& other)
+    : fakeNode_{ &fakeNode_, &fakeNode_ },
+      alloc_(node_traits::select_on_container_copy_construction(other.alloc_)),
+      sz_(0) {
+  try {
+    for (const T& value : other) {
+      push_back(value);
+    }
+  } catch(...) {
+    clear();
+    throw;
+  }
+}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::unrolled_list(unrolled_list&& other) noexcept
+    : fakeNode_{ &fakeNode_, &fakeNode_ },
+      alloc_(other.alloc_),
+      sz_(0) {
+  steal_nodes(other);
+}
+
+template <typename T, typename Alloc, size_t K>
+unrolled_list<T, Alloc, K>::~unrolled_list() {
+  clear();
+}
+
+template <typename T, typename Alloc, size_t K>
+auto unrolled_list<T, Alloc, K>::operator=(const unrolled_list& other) -> unrolled_list& {
+  if (this == &other) {
+    return *this;
+  }
+
+  clear();
+  if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+    alloc_ = other.alloc_;
+  }
+  for (const T& value : other) {
+    push_back(value);
+  }
+  return *this;
+}
+
+template <typename T, typename Alloc, size_t K>
+auto unrolled_list<T, Alloc, K>::operator=(unrolled_list&& other)
+    noexcept(node_traits::propagate_on_container_move_assignment::value
+             || node_traits::is_always_equal::value) -> unrolled_list& {
+  if (this == &other) {
+    return *this;
+  }
+
+  clear();
+  if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+    alloc_ = other.alloc_;
+  } else if (!(alloc_ == other.alloc_)) {
+    // Nodes cannot change hands between unequal allocators, move the elements instead
+    for (T& value : other) {
+      push_back(std::move(value));
+    }
+    other.clear();
+    return *this;
+  }
+  steal_nodes(other);
+  return *this;
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::swap(unrolled_list& other) {
+  unrolled_list temp(alloc_);
+  temp.steal_nodes(*this);
+  steal_nodes(other);
+  other.steal_nodes(temp);
+  if constexpr (node_traits::propagate_on_container_swap::value) {
+    using std::swap;
+    swap(alloc_, other.alloc_);
+  }
+}
+
+template <typename T, typename Alloc, size_t K>
+void unrolled_list<T, Alloc, K>::clear() noexcept {
+  BaseNode* base = fakeNode_.next;
+  while (base != &fakeNode_) {
+    BaseNode* next = base->next;
+    Node* node = static_cast<Node*>(base);
+    std::destroy(node->slot(0), node->slot(node->count));
+    node_traits::destroy(alloc_, node);
+    node_traits::deallocate(alloc_, node, 1);
+    base = next;
+  }
+  fakeNode_.next = &fakeNode_;
+  fakeNode_.prev = &fakeNode_;
+  sz_ = 0;
+}
+
+template <typename T, typename Alloc, size_t K>
+template <typename... Args>
+auto unrolled_list<T, Alloc, K>::emplace(const_iterator pos, Args&&... args) -> iterator {
+  // Built up front: `args` may refer to an element that is about to move
+  T value(std::forward<Args>(args)...);
+
+  Node* node;
+  size_t index = pos.index;
+  BaseNode* prev = pos.node->prev;
+  bool prev_has_room = prev != &fakeNode_ && static_cast<Node*>(prev)->count < K;
+
+  if (index == 0 && prev_has_room) {
+    // Appending to the previous node moves nothing
+    node = static_cast<Node*>(prev);
+    index = node->count;
+  } else if (pos.node == &fakeNode_) {
+    node = create_node(&fakeNode_);
+  } else {
+    node = static_cast<Node*>(pos.node);
+    if (node->count == K) {
+      Node* upper = split(node);
+      if (index > node->count) {
+        index -= node->count;
+        node = upper;
+      }
+    }
+  }
+
+  shift_right(node, index);
+  std::construct_at(node->slot(index), std::move(value));
+  ++node->count;
+  ++sz_;
+  return { node, index };
+}
+
+template <typename T, typename Alloc, size_t K>
+auto unrolled_list<T, Alloc, K>::erase(const_iterator pos) -> iterator {
+  Node* node = static_cast<Node*>(pos.node);
+  size_t index = pos.index;
+  remove_at(node, index);
+  --sz_;
+
+  if (node->count == 0) {
+    BaseNode* next = node->next;
+    destroy_node(node);
+    return { next, 0 };
+  }
+
+  // Keep neighbours from both running nearly empty
+  BaseNode* next = node->next;
+  if (next != &fakeNode_ && node->count + static_cast<Node*>(next)->count <= K / 2) {
+    Node* absorbed = static_cast<Node*>(next);
+    relocate(absorbed, 0, absorbed->count, node);
+    destroy_node(absorbed);
+  }
+
+  if (index < node->count) {
+    return { node, index };
+  }
+  return { node->next, 0 };
+}